@@ -3,3 +3,4 @@ tar xvfz Artemis-2.0.0.tar.gz
 mv Artemis-2.0.0 Artemis
 rm -rf Artemis/artemis-code/src
 mv src Artemis/artemis-code/
+echo "include(src/modified.pri)" >> Artemis/artemis-code/artemis.pro
@@ -24,6 +24,7 @@
 #include "exceptionhandlingqapp.h"
 #include "runtime/options.h"
 #include "artemisapplication.h"
+#include "runtime/browser/executorworker.h"
 #include "util/loggingutil.h"
 
 // MODIFIED by CH
@@ -40,11 +41,13 @@ QUrl parseCmd(int argc, char* argv[], artemis::Options& options)
             "Test the JavaScript application found at <url>.\n"
             "\n"
             "-i <n>   : Iterations - Artemis will generate and execute <n>\n"
-            "           sequences of events. Default is 4.\n"
+            "           sequences of events. Default is 4. 0 means no limit.\n"
             "\n"
             // MODIFIED by CH
             "-q <n> : Test type - 0: default test\n"
             "                   - 1: dependency test\n"
+            "                   - 2: dependency test on the transitive closure of dep.txt\n"
+            "                   - 3: partial-order reduction, one sequence per trace of independent events\n"
             "\n"
 
             "-c <URl> : Cookies - // TODO\n"
@@ -82,7 +85,110 @@ QUrl parseCmd(int argc, char* argv[], artemis::Options& options)
             "           readwrite - use read/write-sets for JavaScript properties to assign priorities\n"
             "\n"
             "--input-strategy-same-length <num>:\n"
-            "           Set the number of permutations of an executed sequence (of same length) generated by the input generator.";
+            "           Set the number of permutations of an executed sequence (of same length) generated by the input generator.\n"
+            "\n"
+            // MODIFIED by CH
+            "--duplicate-filter <filter>:\n"
+            "           Skip configurations whose input sequence was added to the worklist before.\n"
+            "\n"
+            "           none - (default) keep duplicates\n"
+            "           exact - remember the fingerprints of all added sequences\n"
+            "           bloom - as exact, with a Bloom filter in front which saves most lookups of new sequences\n"
+            "\n"
+            "--worklist-memory-limit <num>:\n"
+            "           Keep at most num configurations of the worklist in memory, the rest is written to a\n"
+            "           temporary file and read back when needed. Default is 0, keep everything in memory.\n"
+            "\n"
+            "--fork-after-load:\n"
+            "           Load the page only once. Every sequence is executed in a process forked from the\n"
+            "           loaded page, which sends back the result and the coverage it measured.\n"
+            "\n"
+            "--fork-checkpoints <num>:\n"
+            "           Implies --fork-after-load. Keep up to num forked processes alive, each holding the page\n"
+            "           after an executed sequence, and execute new sequences from the one with the longest\n"
+            "           common prefix. Default is 0.\n"
+            "\n"
+            "--workers <num>:\n"
+            "           Execute up to num sequences at a time, each in a separate worker process which loads\n"
+            "           the page itself. Default is 0, execute in this process. The workers do not use\n"
+            "           --fork-after-load.\n"
+            "\n"
+            "--time-budget <seconds>:\n"
+            "           Stop after the given number of seconds. Use -i 0 to not stop after a number of iterations.\n"
+            "\n"
+            "--coverage-plateau-iterations <num>:\n"
+            "           Stop when num iterations in a row did not cover new lines.\n"
+            "\n"
+            "--coverage-plateau-seconds <seconds>:\n"
+            "           Stop when no new lines were covered for the given number of seconds.\n"
+            "\n"
+            "--termination <mode>:\n"
+            "           Select how -i, --time-budget and the coverage plateau are combined.\n"
+            "\n"
+            "           any - (default) stop when any of them is reached\n"
+            "           all - stop when all of them are reached\n"
+            "\n"
+            "--event-timeout <ms>:\n"
+            "           Stop a sequence once one of its events ran longer than the given number of\n"
+            "           milliseconds. The budget is checked between inputs. A script which does not return\n"
+            "           is only interrupted when WebKit's own script timeout check asks, which happens every\n"
+            "           several seconds and can not be made more frequent, so a runaway loop runs at least\n"
+            "           that long. The rest of the sequence is not executed and no new sequences are\n"
+            "           generated from it. Default is 0, no limit.\n"
+            "\n"
+            "--sequence-timeout <ms>:\n"
+            "           As --event-timeout, but for loading the page and executing the whole sequence.\n"
+            "\n"
+            "--record <path>:\n"
+            "           Write the executed sequences, with their form values and a summary of their results,\n"
+            "           to a binary run log.\n"
+            "\n"
+            "--replay <path>:\n"
+            "           Execute exactly the sequences of a run log written by --record, in the same order,\n"
+            "           without generating or prioritizing sequences. Results which differ from the\n"
+            "           recorded ones are reported.\n"
+            "\n"
+            "--state-abstraction <rule>:\n"
+            "           Leave parts of the page out of the state compared by -s, so states which only differ\n"
+            "           in them count as visited. Can be given more than once.\n"
+            "\n"
+            "           ignore-text - the text of elements\n"
+            "           ignore-attribute=<name> - the attribute name\n"
+            "           handlers-only - everything but the elements with event handlers and their events\n"
+            "           collapse-lists - repetitions of equal consecutive siblings, e.g. list rows\n"
+            "\n"
+            "--dom-diff:\n"
+            "           Find the parts of the page changed by each sequence, and extend the sequence with the\n"
+            "           events of elements in those parts first.\n"
+            "\n"
+            "--pipeline:\n"
+            "           Start loading the next sequence before the new sequences of the last one are generated\n"
+            "           and added to the worklist, so the page is fetched while this is done. Only helps for\n"
+            "           pages loaded over http(s), it is ignored for file:// urls, which are read on the same\n"
+            "           thread. Changes the search order: each pick ignores the new sequences and rescoring of\n"
+            "           the last result, they count from the iteration after the next one.\n"
+            "\n"
+            "--analysis-profile <profile>:\n"
+            "           Select how much of the page is loaded.\n"
+            "\n"
+            "           full - (default) load the page as a browser would\n"
+            "           fast-load - do not download images, audio and video, and do not start plugins\n"
+            "\n"
+            "--resource-cache <pattern>:\n"
+            "           Keep the responses to requests for urls matching the wildcard pattern in memory, and\n"
+            "           serve them from there when the page is loaded again, e.g. \"*.png\" or \"*\". Can be\n"
+            "           given more than once.\n"
+            "\n"
+            "--resource-cache-exclude <pattern>:\n"
+            "           Never cache urls matching the wildcard pattern. Can be given more than once.\n"
+            "\n"
+            "--dependency-file <path>:\n"
+            "           Dependencies used by -q 1, 2 and 3, either a dep.txt or a dep.txt compiled with\n"
+            "           src/compiledeps.js. Default is dep.txt in the current directory.\n"
+            "\n"
+            "--dependency-scc:\n"
+            "           Store the transitive closure used by -q 2 over the strongly connected components of the\n"
+            "           dependency graph instead of over single events. Smaller for graphs with large cycles.";
 
     struct option long_options[] = {
     {"strategy-form-input-generation", required_argument, NULL, 'x'},
@@ -90,6 +196,29 @@ QUrl parseCmd(int argc, char* argv[], artemis::Options& options)
     {"strategy-priority", required_argument, NULL, 'z'},
     {"input-strategy-same-length", required_argument, NULL, 'j'},
     {"coverage-report-ignore", required_argument, NULL, 'k'},
+    // MODIFIED by CH
+    {"dependency-scc", no_argument, NULL, 'a'},
+    {"dependency-file", required_argument, NULL, 'b'},
+    {"duplicate-filter", required_argument, NULL, 'd'},
+    {"worklist-memory-limit", required_argument, NULL, 'm'},
+    {"fork-after-load", no_argument, NULL, 'l'},
+    {"fork-checkpoints", required_argument, NULL, 'o'},
+    {"workers", required_argument, NULL, 'w'},
+    {"worker", required_argument, NULL, 'g'},
+    {"resource-cache", required_argument, NULL, 'e'},
+    {"analysis-profile", required_argument, NULL, 'u'},
+    {"pipeline", no_argument, NULL, 'G'},
+    {"time-budget", required_argument, NULL, 'T'},
+    {"coverage-plateau-iterations", required_argument, NULL, 'I'},
+    {"coverage-plateau-seconds", required_argument, NULL, 'S'},
+    {"termination", required_argument, NULL, 'M'},
+    {"event-timeout", required_argument, NULL, 'E'},
+    {"sequence-timeout", required_argument, NULL, 'Q'},
+    {"record", required_argument, NULL, 'R'},
+    {"replay", required_argument, NULL, 'P'},
+    {"dom-diff", no_argument, NULL, 'D'},
+    {"state-abstraction", required_argument, NULL, 'A'},
+    {"resource-cache-exclude", required_argument, NULL, 'n'},
     {"help", no_argument, NULL, 'h'},
     {0, 0, 0, 0}
     };
@@ -148,6 +277,154 @@ QUrl parseCmd(int argc, char* argv[], artemis::Options& options)
             break;
         }
 
+        case 'a': {
+            options.condenseDependencies = true;
+            break;
+        }
+
+        case 'b': {
+            options.dependencyFile = QString(optarg);
+            break;
+        }
+
+        case 'd': {
+            if (string(optarg).compare("none") == 0) {
+                options.duplicateFilter = artemis::DUPLICATES_KEEP;
+            } else if (string(optarg).compare("exact") == 0) {
+                options.duplicateFilter = artemis::DUPLICATES_EXACT;
+            } else if (string(optarg).compare("bloom") == 0) {
+                options.duplicateFilter = artemis::DUPLICATES_BLOOM;
+            } else {
+                cerr << "ERROR: Invalid choice of duplicate filter " << optarg << endl;
+                exit(1);
+            }
+            break;
+        }
+
+        case 'm': {
+            options.worklistMemoryLimit = QString(optarg).toInt();
+            break;
+        }
+
+        case 'l': {
+            options.forkAfterLoad = true;
+            break;
+        }
+
+        case 'o': {
+            options.forkCheckpoints = QString(optarg).toInt();
+            options.forkAfterLoad = true;
+            break;
+        }
+
+        case 'w': {
+            options.workers = QString(optarg).toInt();
+            break;
+        }
+
+        case 'g': {
+            // internal, started by the executor pool of another artemis process
+            options.workerServer = QString(optarg);
+            break;
+        }
+
+        case 'e': {
+            options.resourceCacheInclude.append(QString(optarg));
+            break;
+        }
+
+        case 'n': {
+            options.resourceCacheExclude.append(QString(optarg));
+            break;
+        }
+
+        case 'T': {
+            options.timeBudget = QString(optarg).toInt();
+            break;
+        }
+
+        case 'I': {
+            options.plateauIterations = QString(optarg).toInt();
+            break;
+        }
+
+        case 'S': {
+            options.plateauSeconds = QString(optarg).toInt();
+            break;
+        }
+
+        case 'M': {
+            if (string(optarg).compare("any") == 0) {
+                options.terminationMode = artemis::TERMINATE_ANY;
+            } else if (string(optarg).compare("all") == 0) {
+                options.terminationMode = artemis::TERMINATE_ALL;
+            } else {
+                cerr << "ERROR: Invalid choice of termination mode " << optarg << endl;
+                exit(1);
+            }
+            break;
+        }
+
+        case 'G': {
+            options.pipelineExecution = true;
+            break;
+        }
+
+        case 'E': {
+            options.eventTimeout = QString(optarg).toInt();
+            break;
+        }
+
+        case 'Q': {
+            options.sequenceTimeout = QString(optarg).toInt();
+            break;
+        }
+
+        case 'R': {
+            options.recordRunLog = QString(optarg);
+            break;
+        }
+
+        case 'P': {
+            options.replayRunLog = QString(optarg);
+            break;
+        }
+
+        case 'D': {
+            options.domDiff = true;
+            break;
+        }
+
+        case 'A': {
+            QString rule = QString(optarg);
+
+            if (rule == "ignore-text") {
+                options.stateAbstraction.ignoreText = true;
+            } else if (rule.startsWith("ignore-attribute=")) {
+                options.stateAbstraction.ignoredAttributes.insert(rule.section('=', 1).toLower());
+            } else if (rule == "handlers-only") {
+                options.stateAbstraction.handlersOnly = true;
+            } else if (rule == "collapse-lists") {
+                options.stateAbstraction.collapseRepeatedSiblings = true;
+            } else {
+                cerr << "ERROR: Invalid choice of state abstraction " << optarg << endl;
+                exit(1);
+            }
+            break;
+        }
+
+        case 'u': {
+            if (string(optarg).compare("full") == 0) {
+                options.analysisProfile = artemis::PROFILE_FULL;
+            } else if (string(optarg).compare("fast-load") == 0) {
+                options.analysisProfile = artemis::PROFILE_FAST_LOAD;
+            } else {
+                cerr << "ERROR: Invalid choice of analysis profile " << optarg << endl;
+                exit(1);
+            }
+            break;
+        }
+
         case 'j': {
             options.numberSameLength = QString(optarg).toInt();
             break;
@@ -297,10 +574,24 @@ int main(int argc, char* argv[])
     artemis::Options options;
     QUrl url = parseCmd(argc, argv, options);
     // MODIFIED by CH
+    if (!options.workerServer.isEmpty()) {
+        artemis::ExecutorWorker worker(0, options, url);
+
+        if (!worker.connectToPool(options.workerServer)) {
+            return 1;
+        }
+
+        return app.exec();
+    }
+
     if (testType == 0) {
         cout << "!!!!!!!!!!!!!!!!!!!!!!!Default Test!!!!!!!!!!!!!!!!!!!!!\n";
     } else if (testType == 1) {
         cout << "!!!!!!!!!!!!!!!!!!!!!!!Dependency Test!!!!!!!!!!!!!!!!!!!!!\n";
+    } else if (testType == 2) {
+        cout << "!!!!!!!!!!!!!!!!!!!!!!!Reachability Test!!!!!!!!!!!!!!!!!!!!!\n";
+    } else if (testType == 3) {
+        cout << "!!!!!!!!!!!!!!!!!!!!!!!Partial-Order Test!!!!!!!!!!!!!!!!!!!!!\n";
     } else {
         testType = 0;
         cout << "!!!!!!!!!!!!!!!!!!!!!!!Default!!!! Test!!!!!!!!!!!!!!!!!!!!!\n";
@@ -36,12 +36,26 @@ size_t CodeBlockInfo::numCoveredBytecodes() const
 
 codeblockid_t CodeBlockInfo::getId(unsigned int sourceOffset, const QUrl& url, int startline)
 {
-    return sourceOffset * 7 + qHash(url) + 37 * startline;
+    return getId(sourceOffset, qHash(url), startline);
 }
 
-void CodeBlockInfo::setBytecodeCovered(uint bytecodeOffset)
+// MODIFIED by CH
+codeblockid_t CodeBlockInfo::getId(unsigned int sourceOffset, uint urlHash, int startline)
 {
+    return sourceOffset * 7 + urlHash + 37 * startline;
+}
+
+/**
+ * Returns true if the bytecode was not covered before.
+ */
+bool CodeBlockInfo::setBytecodeCovered(uint bytecodeOffset)
+{
+    if (mCoveredBytecodes.contains(bytecodeOffset)) {
+        return false;
+    }
+
     mCoveredBytecodes.insert(bytecodeOffset);
+    return true;
 }
 
 }
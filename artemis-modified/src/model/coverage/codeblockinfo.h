@@ -32,10 +32,12 @@ public:
     CodeBlockInfo(QString functionName, size_t bytecodeSize);
 
     size_t getBytecodeSize() const;
-    void setBytecodeCovered(uint bytecodeOffset);
+    bool setBytecodeCovered(uint bytecodeOffset);
     size_t numCoveredBytecodes() const;
 
     static codeblockid_t getId(unsigned sourceOffset, const QUrl& url, int startline);
+    // MODIFIED by CH
+    static codeblockid_t getId(unsigned sourceOffset, uint urlHash, int startline);
 
 private:
     QString mFunctionName;
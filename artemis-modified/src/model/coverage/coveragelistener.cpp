@@ -26,26 +26,38 @@
 namespace artemis
 {
 
+// MODIFIED by CH
+static const int BUFFER_CAPACITY = 4096;
+
 CoverageListener::CoverageListener(const QSet<QUrl>& ignoredUrls) :
     QObject(NULL),
     mIgnoredUrls(ignoredUrls),
-    mInputBeingExecuted(-1)
+    mInputBeingExecuted(-1),
+    mStatementBuffer(BUFFER_CAPACITY),
+    mNumStatements(0),
+    mBytecodeBuffer(BUFFER_CAPACITY),
+    mNumBytecodes(0)
 {
     mIgnoredUrls.insert(DONT_MEASURE_COVERAGE);
+    mLastScript.valid = false;
 }
 
 QList<sourceid_t> CoverageListener::getSourceIDs()
 {
+    flush();
     return mSources.keys();
 }
 
 SourceInfoPtr CoverageListener::getSourceInfo(sourceid_t sourceID)
 {
+    flush();
     return mSources.value(sourceID);
 }
 
 size_t CoverageListener::getNumCoveredLines()
 {
+    flush();
+
     size_t coveredLines = 0;
 
     foreach(SourceInfoPtr source, mSources.values()) {
@@ -58,6 +70,8 @@ size_t CoverageListener::getNumCoveredLines()
 // MODIFIED by CH
 bool CoverageListener::containsLine(uint line)
 {
+    flush();
+
     bool flag = true;
     foreach(SourceInfoPtr source, mSources.values()) {
         flag = source->getLineCoverage().contains(line);
@@ -98,6 +112,9 @@ float CoverageListener::getBytecodeCoverage(QSharedPointer<const BaseInput> inpu
 
 void CoverageListener::notifyStartingEvent(QSharedPointer<const BaseInput> inputEvent)
 {
+    // MODIFIED by CH
+    flush();
+
     mInputBeingExecuted = inputEvent->hashCode();
     if (!mInputToCodeBlockMap.contains(mInputBeingExecuted)) {
         mInputToCodeBlockMap.insert(mInputBeingExecuted, new QSet<codeblockid_t>());
@@ -106,6 +123,9 @@ void CoverageListener::notifyStartingEvent(QSharedPointer<const BaseInput> input
 
 void CoverageListener::notifyStartingLoad()
 {
+    // MODIFIED by CH
+    flush();
+
     mInputBeingExecuted = -1;
 }
 
@@ -123,63 +143,141 @@ void CoverageListener::slJavascriptScriptParsed(QString sourceCode, QUrl sourceU
 
         SourceInfoPtr sourceInfo = SourceInfoPtr(new SourceInfo(sourceCode, sourceUrl, sourceStartLine));
         mSources.insert(sourceID, sourceInfo);
+
+        // MODIFIED by CH
+        // the last resolved script may have been this one before it was known
+        mLastScript.valid = false;
     }
 }
 
+// MODIFIED by CH
 void CoverageListener::slJavascriptStatementExecuted(uint linenumber, QUrl sourceUrl, uint sourceStartLine)
 {
-    if (mIgnoredUrls.contains(sourceUrl)) {
-        return;
+    if (mNumStatements == mStatementBuffer.size()) {
+        flush();
     }
 
-    statistics()->accumulate("WebKit::coverage::covered", 1);
-
-    sourceid_t sourceID = SourceInfo::getId(sourceUrl, sourceStartLine);
-    SourceInfoPtr sourceInfo = mSources.value(sourceID, SourceInfoPtr(NULL));
-
-    if (sourceInfo.isNull()) {
-        qDebug() << "Warning, unknown line " << linenumber << " executed in file at " << sourceUrl << " offset " << sourceStartLine;
-        return;
-    }
-    // MODIFIED by CH
-    /*
-    cout << "covered line!\n";
-    cout << linenumber;
-    cout << "\n";
-    */
-
-    sourceInfo->setLineCovered(linenumber);
+    StatementRecord& record = mStatementBuffer[mNumStatements++];
+    record.linenumber = linenumber;
+    record.sourceStartLine = sourceStartLine;
+    record.sourceUrl = sourceUrl;
 }
 
 void CoverageListener::slJavascriptFunctionCalled(QString functionName, size_t bytecodeSize, uint sourceOffset, QUrl sourceUrl, uint sourceStartLine)
 {
-    if (mIgnoredUrls.contains(sourceUrl)) {
+    // MODIFIED by CH
+    if (!resolveScript(sourceUrl, sourceStartLine)) {
         return;
     }
 
-    codeblockid_t codeBlockID = CodeBlockInfo::getId(sourceOffset, sourceUrl, sourceStartLine);
+    codeblockid_t codeBlockID = CodeBlockInfo::getId(sourceOffset, mLastScript.urlHash, sourceStartLine);
 
     if (!mCodeBlocks.contains(codeBlockID)) {
         mCodeBlocks.insert(codeBlockID, QSharedPointer<CodeBlockInfo>(new CodeBlockInfo(functionName, bytecodeSize)));
     }
 
+    // MODIFIED by CH
     if (mInputBeingExecuted != -1) {
-        mInputToCodeBlockMap.value(mInputBeingExecuted)->insert(codeBlockID);
+        QSet<codeblockid_t>* codeBlocks = mInputToCodeBlockMap.value(mInputBeingExecuted);
+
+        if (!codeBlocks->contains(codeBlockID)) {
+            codeBlocks->insert(codeBlockID);
+            mCodeBlockToInputs[codeBlockID].insert(mInputBeingExecuted);
+            mChangedInputs.insert(mInputBeingExecuted);
+        }
     }
 }
 
+// MODIFIED by CH
 void CoverageListener::slJavascriptBytecodeExecuted(uint bytecodeOffset, uint sourceOffset, QUrl sourceUrl, uint sourceStartLine)
 {
-    if (mIgnoredUrls.contains(sourceUrl)) {
-        return;
+    if (mNumBytecodes == mBytecodeBuffer.size()) {
+        flush();
     }
 
-    codeblockid_t codeBlockID = CodeBlockInfo::getId(sourceOffset, sourceUrl, sourceStartLine);
-    QSharedPointer<CodeBlockInfo> codeBlockInfo = mCodeBlocks.value(codeBlockID, QSharedPointer<CodeBlockInfo>(NULL));
+    BytecodeRecord& record = mBytecodeBuffer[mNumBytecodes++];
+    record.bytecodeOffset = bytecodeOffset;
+    record.sourceOffset = sourceOffset;
+    record.sourceStartLine = sourceStartLine;
+    record.sourceUrl = sourceUrl;
+}
 
-    if (!codeBlockInfo.isNull()) {
-        codeBlockInfo->setBytecodeCovered(bytecodeOffset);
+/**
+ * Returns false if the script is ignored, else mLastScript is the script.
+ */
+bool CoverageListener::resolveScript(const QUrl& sourceUrl, uint sourceStartLine)
+{
+    if (!mLastScript.valid || mLastScript.startLine != sourceStartLine || mLastScript.url != sourceUrl) {
+        mLastScript.valid = true;
+        mLastScript.url = sourceUrl;
+        mLastScript.startLine = sourceStartLine;
+        mLastScript.urlHash = qHash(sourceUrl);
+        mLastScript.ignored = mIgnoredUrls.contains(sourceUrl);
+        mLastScript.source = mSources.value(SourceInfo::getId(mLastScript.urlHash, sourceStartLine), SourceInfoPtr(NULL));
     }
+
+    return !mLastScript.ignored;
+}
+
+void CoverageListener::flush()
+{
+    int covered = 0;
+
+    for (int i = 0; i < mNumStatements; i++) {
+        const StatementRecord& record = mStatementBuffer.at(i);
+
+        if (!resolveScript(record.sourceUrl, record.sourceStartLine)) {
+            continue;
+        }
+
+        covered++;
+
+        if (mLastScript.source.isNull()) {
+            qDebug() << "Warning, unknown line " << record.linenumber << " executed in file at " << record.sourceUrl << " offset " << record.sourceStartLine;
+            continue;
+        }
+
+        mLastScript.source->setLineCovered(record.linenumber);
+    }
+
+    for (int i = 0; i < mNumBytecodes; i++) {
+        const BytecodeRecord& record = mBytecodeBuffer.at(i);
+
+        if (!resolveScript(record.sourceUrl, record.sourceStartLine)) {
+            continue;
+        }
+
+        codeblockid_t codeBlockID = CodeBlockInfo::getId(record.sourceOffset, mLastScript.urlHash, record.sourceStartLine);
+        QSharedPointer<CodeBlockInfo> codeBlockInfo = mCodeBlocks.value(codeBlockID, QSharedPointer<CodeBlockInfo>(NULL));
+
+        if (!codeBlockInfo.isNull() && codeBlockInfo->setBytecodeCovered(record.bytecodeOffset)) {
+            mChangedCodeBlocks.insert(codeBlockID);
+        }
+    }
+
+    if (covered > 0) {
+        statistics()->accumulate("WebKit::coverage::covered", covered);
+    }
+
+    mNumStatements = 0;
+    mNumBytecodes = 0;
+}
+
+// MODIFIED by CH
+QSet<int> CoverageListener::takeChangedInputs()
+{
+    flush();
+
+    QSet<int> changed = mChangedInputs;
+
+    foreach (codeblockid_t codeBlockID, mChangedCodeBlocks) {
+        changed.unite(mCodeBlockToInputs.value(codeBlockID));
+    }
+
+    mChangedInputs.clear();
+    mChangedCodeBlocks.clear();
+
+    return changed;
 }
 
 QString CoverageListener::toString() const
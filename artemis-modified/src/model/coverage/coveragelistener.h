@@ -21,8 +21,10 @@
 #include <QObject>
 #include <QUrl>
 #include <QMap>
+#include <QHash>
 #include <QSet>
 #include <QSharedPointer>
+#include <QVector>
 
 #include "runtime/input/baseinput.h"
 
@@ -34,6 +36,16 @@ namespace artemis
 
 const QUrl DONT_MEASURE_COVERAGE("http://this-is-fake-dont-do-coverage.fake");
 
+// MODIFIED by CH
+/**
+ * @brief The CoverageListener class
+ *
+ * Executed statements and bytecodes are the bulk of the instrumentation, so they are only appended
+ * to preallocated buffers when signalled. The buffers are processed by flush, at the start of every
+ * event and page load, when full, and before coverage is queried. Consecutive records mostly come
+ * from the same script, which is resolved once per run of records instead of hashing its url for
+ * every record.
+ */
 class CoverageListener : public QObject
 {
     Q_OBJECT
@@ -53,6 +65,12 @@ public:
     // MODIFIED by CH
     bool containsLine(uint);
 
+    // MODIFIED by CH
+    // Hash codes of the inputs whose bytecode coverage changed since the last call
+    QSet<int> takeChangedInputs();
+
+    void flush();
+
     QString toString() const;
 
 private:
@@ -69,6 +87,50 @@ private:
     // (codeBlockID -> CodeBlockInfo)
     QMap<codeblockid_t, QSharedPointer<CodeBlockInfo> > mCodeBlocks;
 
+    // MODIFIED by CH
+    // (codeBlockID -> set<inputHashCode>), the inverse of mInputToCodeBlockMap
+    QHash<codeblockid_t, QSet<int> > mCodeBlockToInputs;
+
+    // changes since the last call to takeChangedInputs
+    QSet<codeblockid_t> mChangedCodeBlocks;
+    QSet<int> mChangedInputs;
+
+    struct StatementRecord
+    {
+        uint linenumber;
+        uint sourceStartLine;
+        QUrl sourceUrl;
+    };
+
+    struct BytecodeRecord
+    {
+        uint bytecodeOffset;
+        uint sourceOffset;
+        uint sourceStartLine;
+        QUrl sourceUrl;
+    };
+
+    // the script of the last resolved record
+    struct ResolvedScript
+    {
+        bool valid;
+        QUrl url;
+        uint startLine;
+        uint urlHash;
+        bool ignored;
+        SourceInfoPtr source;
+    };
+
+    bool resolveScript(const QUrl& sourceUrl, uint sourceStartLine);
+
+    QVector<StatementRecord> mStatementBuffer;
+    int mNumStatements;
+
+    QVector<BytecodeRecord> mBytecodeBuffer;
+    int mNumBytecodes;
+
+    ResolvedScript mLastScript;
+
 
 public slots:
 
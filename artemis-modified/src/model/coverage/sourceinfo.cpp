@@ -63,7 +63,13 @@ QDebug operator<<(QDebug dbg, const SourceInfo& e)
 
 sourceid_t SourceInfo::getId(const QUrl& sourceUrl, uint sourceStartLine)
 {
-    return qHash(sourceUrl) * 53 + sourceStartLine * 29;
+    return getId(qHash(sourceUrl), sourceStartLine);
+}
+
+// MODIFIED by CH
+sourceid_t SourceInfo::getId(uint sourceUrlHash, uint sourceStartLine)
+{
+    return sourceUrlHash * 53 + sourceStartLine * 29;
 }
 
 }
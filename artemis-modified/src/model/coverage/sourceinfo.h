@@ -44,6 +44,8 @@ public:
     QDebug friend operator<<(QDebug dbg, const SourceInfo& e);
 
     static sourceid_t getId(const QUrl& sourceUrl, uint sourceStartLine);
+    // MODIFIED by CH
+    static sourceid_t getId(uint sourceUrlHash, uint sourceStartLine);
 
 private:
     QString mSource;
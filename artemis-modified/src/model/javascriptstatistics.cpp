@@ -55,8 +55,14 @@ void JavascriptStatistics::slJavascriptPropertyRead(QString propertyName, intptr
 
     statistics()->accumulate("WebKit::readproperties", 1);
 
+    // MODIFIED by CH
     if (mInputBeingExecuted != 0) {
-        mPropertyReadSet.value(mInputBeingExecuted)->insert(propertyName);
+        QSet<QString>* properties = mPropertyReadSet.value(mInputBeingExecuted);
+
+        if (!properties->contains(propertyName)) {
+            properties->insert(propertyName);
+            mChangedInputs.insert(mInputBeingExecuted);
+        }
     }
 }
 
@@ -68,8 +74,14 @@ void JavascriptStatistics::slJavascriptPropertyWritten(QString propertyName, int
 
     statistics()->accumulate("WebKit::writtenproperties", 1);
 
+    // MODIFIED by CH
     if (mInputBeingExecuted != 0) {
-        mPropertyWriteSet.value(mInputBeingExecuted)->insert(propertyName);
+        QSet<QString>* properties = mPropertyWriteSet.value(mInputBeingExecuted);
+
+        if (!properties->contains(propertyName)) {
+            properties->insert(propertyName);
+            mChangedInputs.insert(mInputBeingExecuted);
+        }
     }
 }
 
@@ -95,4 +107,13 @@ QSet<QString> JavascriptStatistics::getPropertiesRead(const QSharedPointer<const
     return QSet<QString>();
 }
 
+// MODIFIED by CH
+QSet<int> JavascriptStatistics::takeChangedInputs()
+{
+    QSet<int> changed = mChangedInputs;
+    mChangedInputs.clear();
+
+    return changed;
+}
+
 }
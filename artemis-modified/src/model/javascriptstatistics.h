@@ -39,6 +39,10 @@ public:
     QSet<QString> getPropertiesWritten(const QSharedPointer<const BaseInput>& input) const;
     QSet<QString> getPropertiesRead(const QSharedPointer<const BaseInput>& input) const;
 
+    // MODIFIED by CH
+    // Hash codes of the inputs whose read or write set grew since the last call
+    QSet<int> takeChangedInputs();
+
 private:
 
     // InputHash -> set<PropertyString>
@@ -49,6 +53,9 @@ private:
 
     uint mInputBeingExecuted;
 
+    // MODIFIED by CH
+    QSet<int> mChangedInputs;
+
 public slots:
     void slJavascriptPropertyRead(QString propertyName, intptr_t codeBlockID, intptr_t sourceID, QUrl url, int line);
     void slJavascriptPropertyWritten(QString propertyName, intptr_t codeBlockID, intptr_t sourceID, QUrl url, int line);
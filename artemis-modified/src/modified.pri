@@ -0,0 +1,48 @@
+# MODIFIED by CH
+# Sources added on top of the Artemis 2.0.0 release. fetch_Artemis.sh includes this file
+# from artemis-code/artemis.pro, so new files only have to be listed here.
+
+HEADERS += \
+    src/runtime/browser/ajax/cachedreply.h \
+    src/runtime/browser/ajax/resourcecache.h \
+    src/runtime/browser/analysisprofile.h \
+    src/runtime/browser/checkpointtable.h \
+    src/runtime/browser/domstatehasher.h \
+    src/runtime/browser/eventlistenerregistry.h \
+    src/runtime/browser/executionwatchdog.h \
+    src/runtime/browser/executorpool.h \
+    src/runtime/browser/executorworker.h \
+    src/runtime/browser/instrumentationrecorder.h \
+    src/runtime/input/eventkeytable.h \
+    src/runtime/input/inputserializer.h \
+    src/runtime/runlog.h \
+    src/runtime/worklist/dependencyindex.h \
+    src/runtime/worklist/fingerprintset.h \
+    src/runtime/worklist/replayworklist.h \
+    src/runtime/worklist/worklistheap.h \
+    src/strategies/termination/compositetermination.h \
+    src/strategies/termination/coverageplateautermination.h \
+    src/strategies/termination/timebudgettermination.h \
+    src/util/fingerprintutil.h
+
+SOURCES += \
+    src/runtime/browser/ajax/cachedreply.cpp \
+    src/runtime/browser/ajax/resourcecache.cpp \
+    src/runtime/browser/checkpointtable.cpp \
+    src/runtime/browser/domstatehasher.cpp \
+    src/runtime/browser/eventlistenerregistry.cpp \
+    src/runtime/browser/executionwatchdog.cpp \
+    src/runtime/browser/executorpool.cpp \
+    src/runtime/browser/executorworker.cpp \
+    src/runtime/browser/instrumentationrecorder.cpp \
+    src/runtime/input/eventkeytable.cpp \
+    src/runtime/input/inputserializer.cpp \
+    src/runtime/runlog.cpp \
+    src/runtime/worklist/dependencyindex.cpp \
+    src/runtime/worklist/fingerprintset.cpp \
+    src/runtime/worklist/replayworklist.cpp \
+    src/runtime/worklist/worklistheap.cpp \
+    src/strategies/termination/compositetermination.cpp \
+    src/strategies/termination/coverageplateautermination.cpp \
+    src/strategies/termination/timebudgettermination.cpp \
+    src/util/fingerprintutil.cpp
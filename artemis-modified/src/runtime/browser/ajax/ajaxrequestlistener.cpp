@@ -17,20 +17,93 @@
 #include <QNetworkAccessManager>
 #include <QNetworkRequest>
 
+// MODIFIED by CH
+#include <QFileInfo>
+#include <QSet>
+
+#include "statistics/statsstorage.h"
+
+#include "cachedreply.h"
+
 
 namespace artemis
 {
 
 AjaxRequestListener::AjaxRequestListener(QObject* parent) :
-    QNetworkAccessManager(parent)
+    QNetworkAccessManager(parent),
+    mBlockMedia(false)
+{
+}
+
+// MODIFIED by CH
+// a transparent 1x1 gif, images still fire their load events
+static const char BLANK_GIF[] =
+    "GIF89a\x01\x00\x01\x00\x80\x00\x00\x00\x00\x00\xff\xff\xff\x21\xf9\x04\x01\x00\x00\x00\x00"
+    "\x2c\x00\x00\x00\x00\x01\x00\x01\x00\x00\x02\x02\x44\x01\x00\x3b";
+
+static QSet<QString> suffixes(const char* list)
 {
+    return QSet<QString>::fromList(QString(list).split(" "));
+}
+
+QNetworkReply* AjaxRequestListener::createBlockedReply(Operation op, const QNetworkRequest& req)
+{
+    static const QSet<QString> imageSuffixes = suffixes("png gif jpg jpeg bmp ico webp");
+    static const QSet<QString> mediaSuffixes = suffixes("mp3 mp4 m4a ogg oga ogv wav webm avi mov flv swf");
+
+    if (op != GetOperation) {
+        return NULL;
+    }
+
+    QString suffix = QFileInfo(req.url().path()).suffix().toLower();
+    CachedResource resource;
+
+    if (imageSuffixes.contains(suffix)) {
+        resource.statusCode = 200;
+        resource.reasonPhrase = QByteArray("OK");
+        resource.headers.append(QNetworkReply::RawHeaderPair("Content-Type", "image/gif"));
+        resource.data = QByteArray::fromRawData(BLANK_GIF, sizeof(BLANK_GIF) - 1);
+        resource.error = QNetworkReply::NoError;
+
+        statistics()->accumulate("AjaxRequestListener::blocked-images", 1);
+    } else if (mediaSuffixes.contains(suffix)) {
+        resource.error = QNetworkReply::ContentOperationNotPermittedError;
+        resource.errorString = QString("Blocked by the analysis profile");
+
+        statistics()->accumulate("AjaxRequestListener::blocked-media", 1);
+    } else {
+        return NULL;
+    }
+
+    CachedReply* reply = new CachedReply(this, op, req);
+    reply->serve(resource);
+
+    return reply;
 }
 
 QNetworkReply* AjaxRequestListener::createRequest(Operation op, const QNetworkRequest& req, QIODevice* outgoingData)
 
 {
-    //super call
-    QNetworkReply* reply = QNetworkAccessManager::createRequest(op, req, outgoingData);
+    // MODIFIED by CH
+    QNetworkReply* reply = mBlockMedia ? createBlockedReply(op, req) : NULL;
+
+    if (reply == NULL && !mResourceCache.isNull() && mResourceCache->isCacheable(op, req)) {
+        CachedReply* cachedReply = new CachedReply(this, op, req);
+        CachedResource resource;
+
+        if (mResourceCache->lookup(op, req, &resource)) {
+            statistics()->accumulate("AjaxRequestListener::cache-hits", 1);
+            cachedReply->serve(resource);
+        } else {
+            statistics()->accumulate("AjaxRequestListener::cache-misses", 1);
+            cachedReply->fetch(QNetworkAccessManager::createRequest(op, req, outgoingData), mResourceCache);
+        }
+
+        reply = cachedReply;
+    } else if (reply == NULL) {
+        //super call
+        reply = QNetworkAccessManager::createRequest(op, req, outgoingData);
+    }
 
     if (op == GetOperation)
         { emit this->pageGet(req.url()); }
@@ -40,4 +113,14 @@ QNetworkReply* AjaxRequestListener::createRequest(Operation op, const QNetworkRe
     return reply;
 }
 
+void AjaxRequestListener::setResourceCache(ResourceCachePtr cache)
+{
+    mResourceCache = cache;
+}
+
+void AjaxRequestListener::setBlockMedia(bool block)
+{
+    mBlockMedia = block;
+}
+
 }
@@ -18,6 +18,10 @@
 #define AJAXREQUESTLISTENER_H
 #include <QNetworkAccessManager>
 #include <QUrl>
+
+// MODIFIED by CH
+#include "resourcecache.h"
+
 namespace artemis
 {
 
@@ -30,6 +34,18 @@ public:
     explicit AjaxRequestListener(QObject* parent = 0);
     QNetworkReply* createRequest(Operation op, const QNetworkRequest& req, QIODevice* outgoingData = 0);
 
+    // MODIFIED by CH
+    void setResourceCache(ResourceCachePtr cache);
+
+    // answers requests for images with a blank image, and for audio and video with an error
+    void setBlockMedia(bool block);
+
+private:
+    QNetworkReply* createBlockedReply(Operation op, const QNetworkRequest& req);
+
+    ResourceCachePtr mResourceCache;
+    bool mBlockMedia;
+
 signals:
     void pageGet(QUrl url);
     void pagePost(QUrl url);
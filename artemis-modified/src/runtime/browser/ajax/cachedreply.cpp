@@ -0,0 +1,143 @@
+/*
+ * Copyright 2012 Aarhus University
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstring>
+
+#include <QTimer>
+
+#include "cachedreply.h"
+
+namespace artemis
+{
+
+CachedReply::CachedReply(QObject* parent, QNetworkAccessManager::Operation op, const QNetworkRequest& request) :
+    QNetworkReply(parent),
+    mOffset(0),
+    mNetworkReply(NULL)
+{
+    setOperation(op);
+    setRequest(request);
+    setUrl(request.url());
+}
+
+void CachedReply::serve(const CachedResource& resource)
+{
+    setAttribute(QNetworkRequest::HttpStatusCodeAttribute, resource.statusCode);
+    setAttribute(QNetworkRequest::HttpReasonPhraseAttribute, resource.reasonPhrase);
+    setAttribute(QNetworkRequest::RedirectionTargetAttribute, resource.redirectionTarget);
+
+    foreach (QNetworkReply::RawHeaderPair header, resource.headers) {
+        setRawHeader(header.first, header.second);
+    }
+
+    if (resource.error != QNetworkReply::NoError) {
+        setError(resource.error, resource.errorString);
+    }
+
+    mData = resource.data;
+    mOffset = 0;
+
+    open(QIODevice::ReadOnly | QIODevice::Unbuffered);
+
+    // as for network replies, nothing is emitted before the caller had a chance to connect
+    QTimer::singleShot(0, this, SLOT(slEmitResponse()));
+}
+
+void CachedReply::fetch(QNetworkReply* networkReply, ResourceCachePtr cache)
+{
+    mNetworkReply = networkReply;
+    mNetworkReply->setParent(this);
+    mCache = cache;
+
+    QObject::connect(mNetworkReply, SIGNAL(finished()),
+                     this, SLOT(slNetworkReplyFinished()));
+}
+
+void CachedReply::slNetworkReplyFinished()
+{
+    CachedResource resource;
+    resource.statusCode = mNetworkReply->attribute(QNetworkRequest::HttpStatusCodeAttribute);
+    resource.reasonPhrase = mNetworkReply->attribute(QNetworkRequest::HttpReasonPhraseAttribute);
+    resource.redirectionTarget = mNetworkReply->attribute(QNetworkRequest::RedirectionTargetAttribute);
+    resource.headers = mNetworkReply->rawHeaderPairs();
+    resource.data = mNetworkReply->readAll();
+    resource.error = mNetworkReply->error();
+    resource.errorString = mNetworkReply->errorString();
+
+    // errors and redirects are passed on but not cached, non-http urls have no status code
+    if (resource.error == QNetworkReply::NoError &&
+        (!resource.statusCode.isValid() || resource.statusCode.toInt() == 200)) {
+        mCache->insert(operation(), request(), resource);
+    }
+
+    mNetworkReply->deleteLater();
+    mNetworkReply = NULL;
+
+    serve(resource);
+}
+
+void CachedReply::slEmitResponse()
+{
+    emit metaDataChanged();
+
+    if (!mData.isEmpty()) {
+        emit readyRead();
+    }
+
+    emit downloadProgress(mData.size(), mData.size());
+
+    if (error() != QNetworkReply::NoError) {
+        emit error(error());
+    }
+
+    setFinished(true);
+    emit finished();
+}
+
+void CachedReply::abort()
+{
+    if (mNetworkReply != NULL) {
+        mNetworkReply->abort();
+    }
+
+    close();
+}
+
+qint64 CachedReply::bytesAvailable() const
+{
+    return mData.size() - mOffset + QNetworkReply::bytesAvailable();
+}
+
+bool CachedReply::isSequential() const
+{
+    return true;
+}
+
+qint64 CachedReply::readData(char* data, qint64 maxSize)
+{
+    if (mOffset >= mData.size()) {
+        return -1;
+    }
+
+    qint64 size = qMin(maxSize, mData.size() - mOffset);
+
+    memcpy(data, mData.constData() + mOffset, size);
+    mOffset += size;
+
+    return size;
+}
+
+}
@@ -0,0 +1,66 @@
+/*
+ * Copyright 2012 Aarhus University
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef CACHEDREPLY_H
+#define CACHEDREPLY_H
+
+#include <QByteArray>
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <QNetworkRequest>
+
+#include "resourcecache.h"
+
+namespace artemis
+{
+
+/**
+ * @brief The CachedReply class
+ *
+ * A reply served from a ResourceCache. On a cache miss the reply from the network is read
+ * completely first, added to the cache if it succeeded, and then served the same way.
+ */
+class CachedReply : public QNetworkReply
+{
+    Q_OBJECT
+
+public:
+    CachedReply(QObject* parent, QNetworkAccessManager::Operation op, const QNetworkRequest& request);
+
+    void serve(const CachedResource& resource);
+    void fetch(QNetworkReply* networkReply, ResourceCachePtr cache);
+
+    void abort();
+    qint64 bytesAvailable() const;
+    bool isSequential() const;
+
+protected:
+    qint64 readData(char* data, qint64 maxSize);
+
+private:
+    QByteArray mData;
+    qint64 mOffset;
+
+    QNetworkReply* mNetworkReply;
+    ResourceCachePtr mCache;
+
+private slots:
+    void slNetworkReplyFinished();
+    void slEmitResponse();
+};
+
+}
+
+#endif // CACHEDREPLY_H
@@ -0,0 +1,89 @@
+/*
+ * Copyright 2012 Aarhus University
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "statistics/statsstorage.h"
+
+#include "resourcecache.h"
+
+namespace artemis
+{
+
+ResourceCache::ResourceCache(const QStringList& include, const QStringList& exclude)
+{
+    foreach (QString pattern, include) {
+        mInclude.append(QRegExp(pattern, Qt::CaseSensitive, QRegExp::Wildcard));
+    }
+
+    foreach (QString pattern, exclude) {
+        mExclude.append(QRegExp(pattern, Qt::CaseSensitive, QRegExp::Wildcard));
+    }
+}
+
+bool ResourceCache::isCacheable(QNetworkAccessManager::Operation op, const QNetworkRequest& request) const
+{
+    if (op != QNetworkAccessManager::GetOperation && op != QNetworkAccessManager::HeadOperation) {
+        return false;
+    }
+
+    QString url = request.url().toString();
+    bool included = false;
+
+    foreach (QRegExp pattern, mInclude) {
+        if (pattern.exactMatch(url)) {
+            included = true;
+            break;
+        }
+    }
+
+    if (!included) {
+        return false;
+    }
+
+    foreach (QRegExp pattern, mExclude) {
+        if (pattern.exactMatch(url)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool ResourceCache::lookup(QNetworkAccessManager::Operation op, const QNetworkRequest& request, CachedResource* resource) const
+{
+    QHash<QString, CachedResource>::const_iterator iter = mResources.constFind(key(op, request));
+
+    if (iter == mResources.constEnd()) {
+        return false;
+    }
+
+    *resource = iter.value();
+    return true;
+}
+
+void ResourceCache::insert(QNetworkAccessManager::Operation op, const QNetworkRequest& request, const CachedResource& resource)
+{
+    mResources.insert(key(op, request), resource);
+
+    statistics()->accumulate("AjaxRequestListener::cache-resources", 1);
+    statistics()->accumulate("AjaxRequestListener::cache-bytes", resource.data.size());
+}
+
+QString ResourceCache::key(QNetworkAccessManager::Operation op, const QNetworkRequest& request)
+{
+    return QString::number(op) + " " + request.url().toString();
+}
+
+}
@@ -0,0 +1,79 @@
+/*
+ * Copyright 2012 Aarhus University
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef RESOURCECACHE_H
+#define RESOURCECACHE_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <QNetworkRequest>
+#include <QRegExp>
+#include <QSharedPointer>
+#include <QStringList>
+#include <QVariant>
+
+namespace artemis
+{
+
+// Everything a CachedReply needs to replay a response
+struct CachedResource
+{
+    QVariant statusCode;
+    QVariant reasonPhrase;
+    QVariant redirectionTarget;
+    QList<QNetworkReply::RawHeaderPair> headers;
+    QByteArray data;
+    QNetworkReply::NetworkError error;
+    QString errorString;
+};
+
+/**
+ * @brief The ResourceCache class
+ *
+ * Responses to GET and HEAD requests, kept in memory for the whole run, so resources which are
+ * fetched on every page load are only downloaded once. Bodies are implicitly shared QByteArrays,
+ * serving a cached resource does not copy it.
+ *
+ * Only urls matching one of the include patterns and none of the exclude patterns are cached.
+ * Patterns are wildcards matched against the whole url, e.g. "*.png" or "http://localhost/*".
+ */
+class ResourceCache
+{
+
+public:
+    ResourceCache(const QStringList& include, const QStringList& exclude);
+
+    bool isCacheable(QNetworkAccessManager::Operation op, const QNetworkRequest& request) const;
+
+    bool lookup(QNetworkAccessManager::Operation op, const QNetworkRequest& request, CachedResource* resource) const;
+    void insert(QNetworkAccessManager::Operation op, const QNetworkRequest& request, const CachedResource& resource);
+
+private:
+    static QString key(QNetworkAccessManager::Operation op, const QNetworkRequest& request);
+
+    QList<QRegExp> mInclude;
+    QList<QRegExp> mExclude;
+
+    QHash<QString, CachedResource> mResources;
+};
+
+typedef QSharedPointer<ResourceCache> ResourceCachePtr;
+
+}
+
+#endif // RESOURCECACHE_H
@@ -14,9 +14,11 @@
  * limitations under the License.
  */
 #include <QDebug>
+#include <QWebSettings>
 
 #include "artemisglobals.h"
 #include "statistics/statsstorage.h"
+#include "runtime/browser/ajax/ajaxrequestlistener.h"
 
 #include "artemiswebpage.h"
 
@@ -51,4 +53,61 @@ bool ArtemisWebPage::javaScriptPrompt(QWebFrame* frame, const QString& msg, cons
     return true;
 }
 
+// MODIFIED by CH
+/**
+ * The fast-load profile skips the work of a page load which scripts cannot observe: plugins and
+ * Java applets are not started, host names are not prefetched, and images and media are not
+ * downloaded (see AjaxRequestListener::setBlockMedia). Images are replaced by a blank image instead
+ * of being left out, so their load handlers still run.
+ *
+ * Must be called after the network access manager is set.
+ */
+void ArtemisWebPage::setAnalysisProfile(AnalysisProfiles profile)
+{
+    QWebSettings::WebAttribute attributes[] = {
+        QWebSettings::PluginsEnabled, QWebSettings::JavaEnabled, QWebSettings::DnsPrefetchEnabled
+    };
+
+    for (size_t i = 0; i < sizeof(attributes) / sizeof(attributes[0]); i++) {
+        if (profile == PROFILE_FAST_LOAD) {
+            settings()->setAttribute(attributes[i], false);
+        } else {
+            settings()->resetAttribute(attributes[i]);
+        }
+    }
+
+    AjaxRequestListener* ajaxListener = qobject_cast<AjaxRequestListener*>(networkAccessManager());
+
+    if (ajaxListener != NULL) {
+        ajaxListener->setBlockMedia(profile == PROFILE_FAST_LOAD);
+    }
+}
+
+void ArtemisWebPage::setWatchdog(ExecutionWatchdogPtr watchdog)
+{
+    mWatchdog = watchdog;
+}
+
+/**
+ * Interrupts the script if the watchdog budget is exceeded. Without a watchdog the user is asked,
+ * as by QWebPage. WebKit's timeout checker decides when this is called, every several seconds of
+ * script execution, so the budget is only enforced at that granularity here.
+ */
+bool ArtemisWebPage::shouldInterruptJavaScript()
+{
+    if (mWatchdog.isNull()) {
+        return QWebPage::shouldInterruptJavaScript();
+    }
+
+    if (!mWatchdog->isExpired()) {
+        return false;
+    }
+
+    qWarning() << "WARN: Interrupting a long running script";
+    statistics()->accumulate("WebKit::interrupted-scripts", 1);
+
+    mWatchdog->notifyInterrupted();
+    return true;
+}
+
 }
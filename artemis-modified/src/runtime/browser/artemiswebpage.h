@@ -20,6 +20,9 @@
 #include <QString>
 #include <QSharedPointer>
 
+#include "analysisprofile.h"
+#include "executionwatchdog.h"
+
 namespace artemis
 {
 
@@ -34,6 +37,17 @@ public:
     void javaScriptConsoleMessage(const QString& message, int lineNumber, const QString& sourceID);
     bool javaScriptPrompt(QWebFrame* frame, const QString& msg, const QString& defaultValue, QString* result);
 
+    // MODIFIED by CH
+    void setAnalysisProfile(AnalysisProfiles profile);
+    void setWatchdog(ExecutionWatchdogPtr watchdog);
+
+public slots:
+    // called by WebKit while a script runs for long, this is not a virtual function of QWebPage
+    bool shouldInterruptJavaScript();
+
+private:
+    ExecutionWatchdogPtr mWatchdog;
+
 };
 
 typedef QSharedPointer<ArtemisWebPage> ArtemisWebPagePtr;
@@ -0,0 +1,311 @@
+/*
+ * Copyright 2012 Aarhus University
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+
+#include "statistics/statsstorage.h"
+
+#include "checkpointtable.h"
+
+namespace artemis
+{
+
+CheckpointTable::CheckpointTable(int capacity) :
+    mCapacity(capacity),
+    mNextId(0),
+    mClock(0)
+{
+    QByteArray directory = QFile::encodeName(QDir::tempPath() + "/artemis-checkpoints-XXXXXX");
+
+    if (mkdtemp(directory.data()) != NULL) {
+        mDirectory = QFile::decodeName(directory);
+    }
+}
+
+CheckpointTable::~CheckpointTable()
+{
+    clear();
+
+    if (!mDirectory.isEmpty()) {
+        rmdir(QFile::encodeName(mDirectory).constData());
+    }
+}
+
+/**
+ * Finds the longest prefix of sequence (possibly the sequence itself) with a checkpoint.
+ */
+bool CheckpointTable::find(InputSequenceConstPtr sequence, fingerprint_t* prefix, int* prefixLength)
+{
+    for (InputSequenceConstPtr current = sequence; !current->isEmpty(); current = current->getPrefix()) {
+        QHash<fingerprint_t, Checkpoint>::iterator iter = mCheckpoints.find(current->getFingerprint());
+
+        if (iter != mCheckpoints.end()) {
+            iter.value().lastUse = ++mClock;
+            *prefix = iter.key();
+            *prefixLength = current->size();
+            return true;
+        }
+    }
+
+    return false;
+}
+
+pid_t CheckpointTable::pid(fingerprint_t prefix) const
+{
+    return mCheckpoints.value(prefix).pid;
+}
+
+QString CheckpointTable::reserve()
+{
+    if (mDirectory.isEmpty()) {
+        return QString();
+    }
+
+    QString fifo = mDirectory + "/" + QString::number(mNextId++);
+
+    if (mkfifo(QFile::encodeName(fifo).constData(), 0600) != 0) {
+        return QString();
+    }
+
+    return fifo;
+}
+
+void CheckpointTable::release(const QString& fifo)
+{
+    if (!fifo.isEmpty()) {
+        unlink(QFile::encodeName(fifo).constData());
+    }
+}
+
+// without a fifo the process exited after sending its result and was already waited for
+void CheckpointTable::discard(pid_t pid, const QString& fifo)
+{
+    if (fifo.isEmpty()) {
+        return;
+    }
+
+    release(fifo);
+
+    if (pid > 0) {
+        kill(pid, SIGKILL);
+        mExiting.append(pid);
+        reap();
+    }
+}
+
+/**
+ * Registers the process pid, which already opened fifo for reading, as checkpoint of prefix.
+ */
+void CheckpointTable::add(fingerprint_t prefix, pid_t pid, const QString& fifo)
+{
+    reap();
+
+    if (mCheckpoints.contains(prefix)) {
+        remove(prefix);
+    }
+
+    // does not block, the checkpoint opened the pipe before it sent its result
+    int fd = open(QFile::encodeName(fifo).constData(), O_WRONLY | O_NONBLOCK);
+
+    if (fd < 0) {
+        discard(pid, fifo);
+        return;
+    }
+
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) & ~O_NONBLOCK);
+
+    while (mCheckpoints.size() >= mCapacity) {
+        QHash<fingerprint_t, Checkpoint>::const_iterator oldest = mCheckpoints.constBegin();
+
+        for (QHash<fingerprint_t, Checkpoint>::const_iterator iter = mCheckpoints.constBegin(); iter != mCheckpoints.constEnd(); ++iter) {
+            if (iter.value().lastUse < oldest.value().lastUse) {
+                oldest = iter;
+            }
+        }
+
+        remove(oldest.key());
+        statistics()->accumulate("WebKitExecutor::checkpoints-evicted", 1);
+    }
+
+    Checkpoint checkpoint;
+    checkpoint.pid = pid;
+    checkpoint.commandFd = fd;
+    checkpoint.fifo = fifo;
+    checkpoint.lastUse = ++mClock;
+
+    mCheckpoints.insert(prefix, checkpoint);
+}
+
+bool CheckpointTable::send(fingerprint_t prefix, const QByteArray& command)
+{
+    QHash<fingerprint_t, Checkpoint>::const_iterator iter = mCheckpoints.constFind(prefix);
+
+    return iter != mCheckpoints.constEnd() && writeMessage(iter.value().commandFd, command);
+}
+
+void CheckpointTable::remove(fingerprint_t prefix)
+{
+    QHash<fingerprint_t, Checkpoint>::iterator iter = mCheckpoints.find(prefix);
+
+    if (iter == mCheckpoints.end()) {
+        return;
+    }
+
+    QByteArray command;
+    QDataStream stream(&command, QIODevice::WriteOnly);
+    stream << (quint8)CHECKPOINT_EXIT;
+
+    writeMessage(iter.value().commandFd, command);
+    close(iter.value().commandFd);
+    release(iter.value().fifo);
+
+    mExiting.append(iter.value().pid);
+    mCheckpoints.erase(iter);
+}
+
+void CheckpointTable::clear()
+{
+    foreach (fingerprint_t prefix, mCheckpoints.keys()) {
+        remove(prefix);
+    }
+
+    reap();
+}
+
+int CheckpointTable::size() const
+{
+    return mCheckpoints.size();
+}
+
+// waits for ended checkpoints forked by this process, others are waited for by their own parent
+void CheckpointTable::reap()
+{
+    QList<pid_t> exiting;
+
+    foreach (pid_t pid, mExiting) {
+        if (waitpid(pid, NULL, WNOHANG) == 0) {
+            exiting.append(pid);
+        }
+    }
+
+    mExiting = exiting;
+}
+
+bool CheckpointTable::writeMessage(int fd, const QByteArray& message)
+{
+    quint32 length = message.size();
+    QByteArray data = QByteArray((const char*)&length, sizeof(length)) + message;
+
+    const char* bytes = data.constData();
+    qint64 remaining = data.size();
+
+    while (remaining > 0) {
+        ssize_t written = ::write(fd, bytes, remaining);
+
+        if (written < 0 && errno == EINTR) {
+            continue;
+        }
+
+        if (written <= 0) {
+            return false;
+        }
+
+        bytes += written;
+        remaining -= written;
+    }
+
+    return true;
+}
+
+static bool isAlive(pid_t peer)
+{
+    // a child of this process stays visible to kill until it was waited for
+    pid_t waited = waitpid(peer, NULL, WNOHANG);
+
+    if (waited == peer) {
+        return false;
+    }
+
+    if (waited == 0) {
+        return true;
+    }
+
+    return kill(peer, 0) == 0 || errno != ESRCH;
+}
+
+static bool readFully(int fd, char* bytes, qint64 size, pid_t peer)
+{
+    while (size > 0) {
+        struct pollfd request;
+        request.fd = fd;
+        request.events = POLLIN;
+
+        int ready = poll(&request, 1, 1000);
+
+        if (ready < 0 && errno != EINTR) {
+            return false;
+        }
+
+        if (ready <= 0) {
+            if (peer > 0 && !isAlive(peer)) {
+                return false;
+            }
+
+            continue;
+        }
+
+        ssize_t received = ::read(fd, bytes, size);
+
+        if (received < 0 && errno == EINTR) {
+            continue;
+        }
+
+        if (received <= 0) {
+            return false;
+        }
+
+        bytes += received;
+        size -= received;
+    }
+
+    return true;
+}
+
+bool CheckpointTable::readMessage(int fd, QByteArray* message, pid_t peer)
+{
+    quint32 length;
+
+    if (!readFully(fd, (char*)&length, sizeof(length), peer) || length > MAX_MESSAGE_LENGTH) {
+        return false;
+    }
+
+    message->resize(length);
+
+    return readFully(fd, message->data(), length, peer);
+}
+
+}
@@ -0,0 +1,106 @@
+/*
+ * Copyright 2012 Aarhus University
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef CHECKPOINTTABLE_H
+#define CHECKPOINTTABLE_H
+
+#include <sys/types.h>
+
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+#include <QString>
+
+#include "runtime/input/inputsequence.h"
+#include "util/fingerprintutil.h"
+
+namespace artemis
+{
+
+// Commands read by checkpoint processes, see WebKitExecutor::serveCheckpoint
+enum CheckpointCommands {
+    CHECKPOINT_EXECUTE, CHECKPOINT_EXIT
+};
+
+/**
+ * @brief The CheckpointTable class
+ *
+ * Checkpoints are processes holding the page right after a sequence of inputs was applied to it,
+ * waiting for commands on a named pipe. Together they form a trie over the executed sequences: a
+ * new sequence only needs its inputs after the longest prefix with a checkpoint.
+ *
+ * The table is kept by the process which owns the worklist. It holds at most capacity checkpoints
+ * and ends the least recently used one to make room for a new one.
+ *
+ * Messages on all pipes are a 32 bit length followed by that many bytes.
+ */
+class CheckpointTable
+{
+
+public:
+    CheckpointTable(int capacity);
+    ~CheckpointTable();
+
+    bool find(InputSequenceConstPtr sequence, fingerprint_t* prefix, int* prefixLength);
+    pid_t pid(fingerprint_t prefix) const;
+
+    // path of the named pipe for the next checkpoint, empty if it could not be created
+    QString reserve();
+    void release(const QString& fifo);
+
+    // ends a process which was forked for fifo but will not be added as checkpoint
+    void discard(pid_t pid, const QString& fifo);
+
+    void add(fingerprint_t prefix, pid_t pid, const QString& fifo);
+    bool send(fingerprint_t prefix, const QByteArray& command);
+    void remove(fingerprint_t prefix);
+    void clear();
+
+    int size() const;
+
+    static const quint32 MAX_MESSAGE_LENGTH = 256 * 1024 * 1024;
+
+    static bool writeMessage(int fd, const QByteArray& message);
+
+    // gives up if the process peer disappears while waiting, or the length exceeds MAX_MESSAGE_LENGTH
+    static bool readMessage(int fd, QByteArray* message, pid_t peer);
+
+private:
+    struct Checkpoint
+    {
+        pid_t pid;
+        int commandFd;
+        QString fifo;
+        quint64 lastUse;
+    };
+
+    void reap();
+
+    int mCapacity;
+    QString mDirectory;
+    int mNextId;
+    quint64 mClock;
+
+    QHash<fingerprint_t, Checkpoint> mCheckpoints;
+
+    // ended checkpoints which were forked by this process and have not been waited for
+    QList<pid_t> mExiting;
+
+    Q_DISABLE_COPY(CheckpointTable)
+};
+
+}
+
+#endif // CHECKPOINTTABLE_H
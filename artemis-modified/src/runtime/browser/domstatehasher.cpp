@@ -0,0 +1,234 @@
+/*
+ * Copyright 2012 Aarhus University
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <vector>
+
+#include <QStringList>
+
+#include "domstatehasher.h"
+
+namespace artemis
+{
+
+DomStateHasher::DomStateHasher(const DomStateAbstraction& abstraction) :
+    mAbstraction(abstraction),
+    mNumHashedElements(0)
+{
+}
+
+/**
+ * Post-order walk with an explicit stack, as pages can be nested deeper than the native stack
+ * allows. The exact and the abstract hash are accumulated side by side.
+ */
+fingerprint_t DomStateHasher::hash(const QWebElement& root, DomStateTree* tree, fingerprint_t* abstractHash)
+{
+    if (tree != NULL) {
+        tree->clear();
+    }
+
+    if (root.isNull()) {
+        if (abstractHash != NULL) {
+            *abstractHash = FINGERPRINT_SEED;
+        }
+
+        return FINGERPRINT_SEED;
+    }
+
+    struct Frame
+    {
+        fingerprint_t hash;
+        fingerprint_t abstractHash;
+        QWebElement next; // next child to hash
+        int node; // index in tree
+        fingerprint_t lastChild; // abstract subtree of the previous child, for collapseRepeatedSiblings
+        bool hasLastChild;
+    };
+
+    std::vector<Frame> stack;
+    QWebElement element = root;
+
+    while (true) {
+        if (!element.isNull()) {
+            Frame frame;
+            frame.next = element.firstChild();
+            frame.abstractHash = 0;
+            frame.hash = hashShallow(element, frame.next.isNull(), abstractHash != NULL ? &frame.abstractHash : NULL);
+            frame.node = -1;
+            frame.lastChild = 0;
+            frame.hasLastChild = false;
+
+            if (tree != NULL) {
+                DomStateNode node = {frame.hash, 0, 0, 0};
+                frame.node = tree->size();
+                tree->append(node);
+            }
+
+            stack.push_back(frame);
+        }
+
+        Frame& top = stack.back();
+
+        if (!top.next.isNull()) {
+            element = top.next;
+            top.next = element.nextSibling();
+
+            continue;
+        }
+
+        element = QWebElement();
+
+        fingerprint_t subtree = top.hash;
+        fingerprint_t abstractSubtree = top.abstractHash;
+
+        if (tree != NULL) {
+            (*tree)[top.node].subtree = subtree;
+            (*tree)[top.node].size = tree->size() - top.node;
+        }
+
+        stack.pop_back();
+
+        if (stack.empty()) {
+            if (abstractHash != NULL) {
+                *abstractHash = abstractSubtree;
+            }
+
+            return subtree;
+        }
+
+        Frame& parent = stack.back();
+
+        parent.hash = fingerprintCombine(parent.hash, subtree);
+
+        if (abstractHash != NULL) {
+            if (!mAbstraction.collapseRepeatedSiblings || !parent.hasLastChild || parent.lastChild != abstractSubtree) {
+                parent.abstractHash = fingerprintCombine(parent.abstractHash, abstractSubtree);
+            }
+
+            parent.lastChild = abstractSubtree;
+            parent.hasLastChild = true;
+        }
+
+        if (tree != NULL) {
+            (*tree)[parent.node].numChildren++;
+        }
+    }
+}
+
+/**
+ * Compares the trees top-down and skips equal subtrees. An element is reported if it differs
+ * itself or its number of children changed, otherwise its differing children are compared.
+ */
+QList<DomPath> DomStateHasher::diff(const DomStateTree& before, const DomStateTree& after)
+{
+    QList<DomPath> regions;
+
+    if (before.isEmpty() || after.isEmpty()) {
+        if (before.size() != after.size()) {
+            regions.append(DomPath());
+        }
+
+        return regions;
+    }
+
+    struct Pair
+    {
+        int before;
+        int after;
+        DomPath path;
+    };
+
+    std::vector<Pair> stack;
+    Pair root = {0, 0, DomPath()};
+    stack.push_back(root);
+
+    while (!stack.empty()) {
+        Pair pair = stack.back();
+        stack.pop_back();
+
+        const DomStateNode& b = before.at(pair.before);
+        const DomStateNode& a = after.at(pair.after);
+
+        if (b.subtree == a.subtree) {
+            continue;
+        }
+
+        if (b.shallow != a.shallow || b.numChildren != a.numChildren) {
+            regions.append(pair.path);
+            continue;
+        }
+
+        int childBefore = pair.before + 1;
+        int childAfter = pair.after + 1;
+
+        for (int i = 1; i <= a.numChildren; i++) {
+            Pair child = {childBefore, childAfter, pair.path};
+            child.path.append(i);
+            stack.push_back(child);
+
+            childBefore += before.at(childBefore).size;
+            childAfter += after.at(childAfter).size;
+        }
+    }
+
+    return regions;
+}
+
+quint64 DomStateHasher::numHashedElements() const
+{
+    return mNumHashedElements;
+}
+
+/**
+ * Tag and attributes, plus the text if the element has no child elements. The abstract hash is
+ * only computed if abstractHash is set, from the same attribute values and text.
+ */
+fingerprint_t DomStateHasher::hashShallow(const QWebElement& element, bool isLeaf, fingerprint_t* abstractHash)
+{
+    mNumHashedElements++;
+
+    fingerprint_t hash = fingerprintString(element.tagName());
+    fingerprint_t abstract = hash;
+
+    foreach (QString name, element.attributeNames()) {
+        fingerprint_t value = fingerprintString(element.attribute(name));
+
+        hash = fingerprintCombine(fingerprintString(name, hash), value);
+
+        if (abstractHash != NULL &&
+            (mAbstraction.ignoredAttributes.isEmpty() || !mAbstraction.ignoredAttributes.contains(name.toLower()))) {
+            abstract = fingerprintCombine(fingerprintString(name, abstract), value);
+        }
+    }
+
+    if (isLeaf) {
+        // the escaped text, does not need a layout as toPlainText does
+        fingerprint_t text = fingerprintString(element.toInnerXml());
+
+        hash = fingerprintCombine(hash, text);
+
+        if (!mAbstraction.ignoreText) {
+            abstract = fingerprintCombine(abstract, text);
+        }
+    }
+
+    if (abstractHash != NULL) {
+        *abstractHash = abstract;
+    }
+
+    return hash;
+}
+
+}
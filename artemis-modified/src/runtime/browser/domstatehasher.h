@@ -0,0 +1,114 @@
+/*
+ * Copyright 2012 Aarhus University
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef DOMSTATEHASHER_H
+#define DOMSTATEHASHER_H
+
+#include <QList>
+#include <QSet>
+#include <QString>
+#include <QVector>
+#include <QWebElement>
+
+#include "util/fingerprintutil.h"
+
+namespace artemis
+{
+
+struct DomStateNode
+{
+    fingerprint_t shallow; // tag, attributes and text of the element itself
+    fingerprint_t subtree;
+    int numChildren;
+    int size; // number of elements in the subtree, including this one
+};
+
+// The hashed elements in pre-order, the children of a node follow it
+typedef QVector<DomStateNode> DomStateTree;
+
+// Path from the root of a walk to an element, as 1-based child indexes. DomStateHasher paths start
+// at the element it hashed, DOMElementDescriptor paths start at <body>.
+typedef QList<int> DomPath;
+
+/**
+ * What is left out of the abstract page state used to detect visited states (-s). The default
+ * is the exact state.
+ */
+struct DomStateAbstraction
+{
+    DomStateAbstraction() :
+        ignoreText(false),
+        handlersOnly(false),
+        collapseRepeatedSiblings(false)
+    {}
+
+    bool isExact() const
+    {
+        return !ignoreText && ignoredAttributes.isEmpty() && !handlersOnly && !collapseRepeatedSiblings;
+    }
+
+    bool ignoreText;
+    QSet<QString> ignoredAttributes; // lower case
+
+    // the state is only the elements with event handlers and their events, see ExecutionResultBuilder
+    bool handlersOnly;
+
+    // consecutive siblings with equal (abstract) subtrees count once, e.g. the rows of a list
+    bool collapseRepeatedSiblings;
+};
+
+/**
+ * @brief The DomStateHasher class
+ *
+ * Hashes the DOM tree below an element in a single walk, without serializing it. The hash of an
+ * element combines its tag, its attributes (in document order) and the hashes of its children,
+ * so equal subtrees get equal hashes wherever they appear.
+ *
+ * Text is only part of the hash for elements without child elements. QWebElement does not expose
+ * text nodes, and the text of an element with child elements can only be read by serializing the
+ * whole subtree again. A change of text next to child elements, as in <p>3 <b>items</b></p>, is
+ * therefore not seen. Live form values are not part of the DOM and not part of the hash.
+ *
+ * If a tree is passed to hash, the hashes of all elements are recorded in it, and diff lists the
+ * subtrees which differ between two recorded trees.
+ *
+ * hash returns the exact state. If abstractHash is passed, the state under the abstraction the
+ * hasher was created with is computed in the same walk, leaving out the text, attributes and
+ * repeated siblings the abstraction lists.
+ */
+class DomStateHasher
+{
+
+public:
+    DomStateHasher(const DomStateAbstraction& abstraction = DomStateAbstraction());
+
+    fingerprint_t hash(const QWebElement& root, DomStateTree* tree = NULL, fingerprint_t* abstractHash = NULL);
+
+    // the smallest subtrees of after which differ from before, empty if the trees are equal
+    static QList<DomPath> diff(const DomStateTree& before, const DomStateTree& after);
+
+    // elements hashed since this hasher was created
+    quint64 numHashedElements() const;
+
+private:
+    fingerprint_t hashShallow(const QWebElement& element, bool isLeaf, fingerprint_t* abstractHash);
+
+    DomStateAbstraction mAbstraction;
+    quint64 mNumHashedElements;
+};
+
+}
+
+#endif // DOMSTATEHASHER_H
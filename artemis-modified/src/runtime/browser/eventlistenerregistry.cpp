@@ -0,0 +1,129 @@
+/*
+ * Copyright 2012 Aarhus University
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "eventlistenerregistry.h"
+
+namespace artemis
+{
+
+EventListenerRegistry::EventListenerRegistry() :
+    mNumRemoved(0)
+{
+}
+
+void EventListenerRegistry::add(QWebElement* element, const QString& name)
+{
+    mIndex[Key(element, eventTypeId(name))].append(mEntries.size());
+
+    mEntries.append(EventListener(element, name));
+    mRemoved.append(false);
+}
+
+bool EventListenerRegistry::remove(QWebElement* element, const QString& name)
+{
+    QHash<QString, int>::const_iterator type = mEventTypeIds.constFind(name);
+
+    if (type == mEventTypeIds.constEnd()) {
+        return false;
+    }
+
+    QHash<Key, QList<int> >::iterator iter = mIndex.find(Key(element, type.value()));
+
+    if (iter == mIndex.end()) {
+        return false;
+    }
+
+    mRemoved[iter.value().takeFirst()] = true;
+    mNumRemoved++;
+
+    if (iter.value().isEmpty()) {
+        mIndex.erase(iter);
+    }
+
+    if (mNumRemoved > 16 && mNumRemoved * 2 > mEntries.size()) {
+        compact();
+    }
+
+    return true;
+}
+
+void EventListenerRegistry::clear()
+{
+    mEntries.clear();
+    mRemoved.clear();
+    mIndex.clear();
+    mNumRemoved = 0;
+}
+
+int EventListenerRegistry::size() const
+{
+    return mEntries.size() - mNumRemoved;
+}
+
+QList<EventListener> EventListenerRegistry::listeners() const
+{
+    QList<EventListener> result;
+    result.reserve(size());
+
+    for (int i = 0; i < mEntries.size(); i++) {
+        if (!mRemoved.at(i)) {
+            result.append(mEntries.at(i));
+        }
+    }
+
+    return result;
+}
+
+int EventListenerRegistry::eventTypeId(const QString& name)
+{
+    QHash<QString, int>::const_iterator iter = mEventTypeIds.constFind(name);
+
+    if (iter != mEventTypeIds.constEnd()) {
+        return iter.value();
+    }
+
+    int id = mEventTypeIds.size();
+    mEventTypeIds.insert(name, id);
+
+    return id;
+}
+
+/**
+ * Drops the removed entries and renumbers the index
+ */
+void EventListenerRegistry::compact()
+{
+    QVector<EventListener> entries;
+    entries.reserve(size());
+
+    mIndex.clear();
+
+    for (int i = 0; i < mEntries.size(); i++) {
+        if (mRemoved.at(i)) {
+            continue;
+        }
+
+        const EventListener& listener = mEntries.at(i);
+        mIndex[Key(listener.first, eventTypeId(listener.second))].append(entries.size());
+        entries.append(listener);
+    }
+
+    mEntries = entries;
+    mRemoved.fill(false, mEntries.size());
+    mNumRemoved = 0;
+}
+
+}
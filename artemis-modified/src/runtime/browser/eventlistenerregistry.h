@@ -0,0 +1,74 @@
+/*
+ * Copyright 2012 Aarhus University
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef EVENTLISTENERREGISTRY_H
+#define EVENTLISTENERREGISTRY_H
+
+#include <QHash>
+#include <QList>
+#include <QPair>
+#include <QString>
+#include <QVector>
+#include <QWebElement>
+
+namespace artemis
+{
+
+typedef QPair<QWebElement*, QString> EventListener;
+
+/**
+ * @brief The EventListenerRegistry class
+ *
+ * The event listeners added to the page and not removed again, in the order they were added.
+ * Adding and removing take constant time, listeners are indexed by element and event type id.
+ *
+ * The same listener can be added more than once, remove then removes the earliest one. Removed
+ * listeners leave a hole in the order, which is closed once half of the entries are holes.
+ */
+class EventListenerRegistry
+{
+
+public:
+    EventListenerRegistry();
+
+    void add(QWebElement* element, const QString& name);
+
+    // false if the listener was not registered
+    bool remove(QWebElement* element, const QString& name);
+
+    void clear();
+    int size() const;
+
+    QList<EventListener> listeners() const;
+
+private:
+    typedef QPair<QWebElement*, int> Key;
+
+    int eventTypeId(const QString& name);
+    void compact();
+
+    QVector<EventListener> mEntries;
+    QVector<bool> mRemoved;
+    int mNumRemoved;
+
+    // positions of the registered entries of each key, ascending
+    QHash<Key, QList<int> > mIndex;
+
+    QHash<QString, int> mEventTypeIds;
+};
+
+}
+
+#endif // EVENTLISTENERREGISTRY_H
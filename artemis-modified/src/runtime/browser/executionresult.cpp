@@ -25,6 +25,25 @@ ExecutionResult::ExecutionResult()
 {
     mModifiedDom = false;
     mStateHash = 0;
+    // MODIFIED by CH
+    mTimedOut = false;
+    mAbstractStateHash = 0;
+}
+
+// MODIFIED by CH
+bool ExecutionResult::isTimedOut() const
+{
+    return mTimedOut;
+}
+
+QList<DomPath> ExecutionResult::getModifiedRegions() const
+{
+    return mModifiedRegions;
+}
+
+long ExecutionResult::getAbstractPageStateHash() const
+{
+    return mAbstractStateHash;
 }
 
 QString ExecutionResult::getPageContents() const
@@ -82,6 +101,93 @@ void ExecutionResult::addJavascriptConstantObservedForLastEvent(QString constant
     mJavascriptConstantsObservedForLastEvent.insert(constant);
 }
 
+// MODIFIED by CH
+void ExecutionResult::write(QDataStream& stream) const
+{
+    stream << (quint32)mEventHandlers.size();
+
+    foreach (EventHandlerDescriptor* handler, mEventHandlers) {
+        handler->write(stream);
+    }
+
+    stream << (quint32)mFormFields.size();
+
+    foreach (QSharedPointer<const FormField> field, mFormFields) {
+        field->write(stream);
+    }
+
+    stream << mModifiedDom << (qint64)mStateHash << mPageContents;
+
+    stream << (quint32)mAjaxRequest.size();
+
+    foreach (QSharedPointer<AjaxRequest> request, mAjaxRequest) {
+        stream << request->url() << request->postData();
+    }
+
+    stream << mAjaxCallbackHandlers << mEvaledStrings;
+
+    stream << (quint32)mTimers.size();
+
+    foreach (QSharedPointer<Timer> timer, mTimers) {
+        stream << (qint32)timer->getId() << (qint32)timer->getTimeout() << timer->isSingleShot();
+    }
+
+    stream << mJavascriptConstantsObservedForLastEvent << mTimedOut << mModifiedRegions << (qint64)mAbstractStateHash;
+}
+
+QSharedPointer<ExecutionResult> ExecutionResult::read(QDataStream& stream)
+{
+    QSharedPointer<ExecutionResult> result = QSharedPointer<ExecutionResult>(new ExecutionResult());
+    quint32 size;
+
+    stream >> size;
+
+    for (quint32 i = 0; i < size && stream.status() == QDataStream::Ok; i++) {
+        result->mEventHandlers.append(new EventHandlerDescriptor(NULL, stream));
+    }
+
+    stream >> size;
+
+    for (quint32 i = 0; i < size && stream.status() == QDataStream::Ok; i++) {
+        result->mFormFields.insert(FormField::read(stream));
+    }
+
+    qint64 stateHash;
+    stream >> result->mModifiedDom >> stateHash >> result->mPageContents;
+    result->mStateHash = stateHash;
+
+    stream >> size;
+
+    for (quint32 i = 0; i < size && stream.status() == QDataStream::Ok; i++) {
+        QUrl url;
+        QString postData;
+        stream >> url >> postData;
+
+        result->mAjaxRequest.insert(QSharedPointer<AjaxRequest>(new AjaxRequest(url, postData)));
+    }
+
+    stream >> result->mAjaxCallbackHandlers >> result->mEvaledStrings;
+
+    stream >> size;
+
+    for (quint32 i = 0; i < size && stream.status() == QDataStream::Ok; i++) {
+        qint32 id;
+        qint32 timeout;
+        bool singleShot;
+        stream >> id >> timeout >> singleShot;
+
+        result->mTimers.insert(id, QSharedPointer<Timer>(new Timer(id, timeout, singleShot)));
+    }
+
+    stream >> result->mJavascriptConstantsObservedForLastEvent >> result->mTimedOut >> result->mModifiedRegions;
+
+    qint64 abstractStateHash;
+    stream >> abstractStateHash;
+    result->mAbstractStateHash = abstractStateHash;
+
+    return result;
+}
+
 QDebug operator<<(QDebug dbg, const ExecutionResult& e)
 {
     dbg.nospace() << "Event handlers: " << e.mEventHandlers << "\n";
@@ -21,12 +21,14 @@
 #include <QSet>
 #include <QPair>
 #include <QList>
+#include <QDataStream>
 
 #include "artemisglobals.h"
 #include "runtime/input/events/eventhandlerdescriptor.h"
 #include "runtime/input/forms/formfield.h"
 #include "runtime/browser/timer.h"
 #include "runtime/browser/ajax/ajaxrequest.h"
+#include "runtime/browser/domstatehasher.h"
 
 namespace artemis
 {
@@ -42,6 +44,8 @@ public:
 
     bool isDomModified() const;
     long getPageStateHash() const;
+    // MODIFIED by CH
+    // empty unless page states are dumped (-p), see ExecutionResultBuilder::setKeepPageContents
     QString getPageContents() const;
 
     QSet<QSharedPointer<AjaxRequest> > getAjaxRequests() const;
@@ -55,6 +59,21 @@ public:
 
     QDebug friend operator<<(QDebug dbg, const ExecutionResult& e);
 
+    // MODIFIED by CH
+    // The execution was stopped by the ExecutionWatchdog, not all inputs may have been applied
+    bool isTimedOut() const;
+
+    // The subtrees of <body> changed since the page was loaded, only listed with --dom-diff.
+    // The paths start at <body>, as those of DOMElementDescriptor, an empty path is the whole page.
+    QList<DomPath> getModifiedRegions() const;
+
+    // The page state under the configured DomStateAbstraction, used to detect visited states
+    long getAbstractPageStateHash() const;
+
+    // Used to send results from another process, see WebKitExecutor
+    void write(QDataStream& stream) const;
+    static QSharedPointer<ExecutionResult> read(QDataStream& stream);
+
     friend class ExecutionResultBuilder;
 
 private:
@@ -73,6 +92,11 @@ private:
 
     QSet<QString> mJavascriptConstantsObservedForLastEvent;
 
+    // MODIFIED by CH
+    bool mTimedOut;
+    QList<DomPath> mModifiedRegions;
+    long mAbstractStateHash;
+
 };
 
 }
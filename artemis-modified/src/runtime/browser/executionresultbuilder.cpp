@@ -27,6 +27,9 @@ namespace artemis
 ExecutionResultBuilder::ExecutionResultBuilder(ArtemisWebPagePtr page) : QObject(NULL)
 {
     mPage = page;
+    // MODIFIED by CH
+    mKeepPageContents = false;
+    mDiffMode = false;
     reset();
 }
 
@@ -34,12 +37,15 @@ void ExecutionResultBuilder::reset()
 {
     mResult = QSharedPointer<ExecutionResult>(new ExecutionResult());
     mElementPointers.clear();
-    mPageStateAfterLoad = QString("");
+    // MODIFIED by CH
+    mPageStateAfterLoad = 0;
+    mTreeAfterLoad.clear();
 }
 
 void ExecutionResultBuilder::notifyPageLoaded()
 {
-    mPageStateAfterLoad = mPage->mainFrame()->toHtml();
+    // MODIFIED by CH
+    mPageStateAfterLoad = hashPageState(mDiffMode ? &mTreeAfterLoad : NULL, NULL);
 }
 
 void ExecutionResultBuilder::notifyStartingEvent()
@@ -57,18 +63,153 @@ QSharedPointer<ExecutionResult> ExecutionResultBuilder::getResult()
     registerFromFieldsIntoResult();
     registerEventHandlersIntoResult();
 
-    mResult->mPageContents = mPage->mainFrame()->toHtml();
-    mResult->mStateHash = qHash(mResult->mPageContents);
-    mResult->mModifiedDom = mResult->mPageContents.localeAwareCompare(mPageStateAfterLoad) != 0;
+    // MODIFIED by CH
+    fingerprint_t abstractState = 0;
+    fingerprint_t state = hashPageState(mDiffMode ? &mTree : NULL, hasDomAbstraction() ? &abstractState : NULL);
+
+    mResult->mStateHash = (long)state;
+    mResult->mAbstractStateHash = (long)(hasDomAbstraction() ? abstractState : hashAbstractPageState(state));
+    mResult->mModifiedDom = state != mPageStateAfterLoad;
+
+    if (mDiffMode && mResult->mModifiedDom) {
+        mResult->mModifiedRegions = toBodyPaths(DomStateHasher::diff(mTreeAfterLoad, mTree));
+        statistics()->accumulate("ExecutionResultBuilder::modified-regions", mResult->mModifiedRegions.size());
+    }
+
+    if (mKeepPageContents) {
+        mResult->mPageContents = mPage->mainFrame()->toHtml();
+    }
 
     return mResult;
 }
 
+// MODIFIED by CH
+fingerprint_t ExecutionResultBuilder::hashPageState(DomStateTree* tree, fingerprint_t* abstractState)
+{
+    quint64 hashedElements = mHasher.numHashedElements();
+    fingerprint_t state = mHasher.hash(mPage->mainFrame()->documentElement(), tree, abstractState);
+
+    statistics()->accumulate("ExecutionResultBuilder::hashed-elements", (int)(mHasher.numHashedElements() - hashedElements));
+
+    return state;
+}
+
+// the abstract state is hashed along with the exact one, in the same walk over the page
+bool ExecutionResultBuilder::hasDomAbstraction() const
+{
+    return !mAbstraction.isExact() && !mAbstraction.handlersOnly;
+}
+
+/**
+ * The abstract state of an exact abstraction or with handlersOnly, which is not computed by the
+ * hasher. With handlersOnly it only consists of the event handlers of the result, which are
+ * registered before the state is hashed.
+ */
+fingerprint_t ExecutionResultBuilder::hashAbstractPageState(fingerprint_t state)
+{
+    if (!mAbstraction.handlersOnly) {
+        return state;
+    }
+
+    QList<fingerprint_t> handlers;
+
+    foreach (EventHandlerDescriptor* handler, mResult->mEventHandlers) {
+        handlers.append(handler->fingerprint());
+    }
+
+    // the order in which the handlers were added does not matter
+    qSort(handlers);
+
+    fingerprint_t hash = FINGERPRINT_SEED;
+
+    foreach (fingerprint_t handler, handlers) {
+        hash = fingerprintCombine(hash, handler);
+    }
+
+    return hash;
+}
+
+void ExecutionResultBuilder::setStateAbstraction(const DomStateAbstraction& abstraction)
+{
+    mAbstraction = abstraction;
+    mHasher = DomStateHasher(abstraction);
+}
+
+void ExecutionResultBuilder::setKeepPageContents(bool keepPageContents)
+{
+    mKeepPageContents = keepPageContents;
+}
+
+/**
+ * The hasher walks from <html>, the descriptors of event handlers and form fields have paths
+ * starting at <body>. Changes outside of <body> are dropped, a change of <html> or <body> itself
+ * is a change of the whole page.
+ */
+QList<DomPath> ExecutionResultBuilder::toBodyPaths(const QList<DomPath>& regions) const
+{
+    QList<DomPath> result;
+
+    int bodyIndex = 1;
+    QWebElement child = mPage->mainFrame()->documentElement().firstChild();
+
+    while (!child.isNull() && child.tagName().toLower() != "body") {
+        child = child.nextSibling();
+        bodyIndex++;
+    }
+
+    if (child.isNull()) {
+        return result;
+    }
+
+    foreach (const DomPath& region, regions) {
+        if (region.size() <= 1 && (region.isEmpty() || region.first() == bodyIndex)) {
+            result.clear();
+            result.append(DomPath());
+            return result;
+        }
+
+        if (region.first() == bodyIndex) {
+            result.append(region.mid(1));
+        }
+    }
+
+    return result;
+}
+
+void ExecutionResultBuilder::setDiffMode(bool diffMode)
+{
+    mDiffMode = diffMode;
+}
+
+// MODIFIED by CH
+void ExecutionResultBuilder::saveLoadedState()
+{
+    mLoadedResult = *mResult;
+    mLoadedPageState = mPageStateAfterLoad;
+    mLoadedTree = mTreeAfterLoad;
+    mLoadedElementPointers = mElementPointers;
+}
+
+void ExecutionResultBuilder::restoreLoadedState()
+{
+    mResult = QSharedPointer<ExecutionResult>(new ExecutionResult(mLoadedResult));
+    mPageStateAfterLoad = mLoadedPageState;
+    mTreeAfterLoad = mLoadedTree;
+    mElementPointers = mLoadedElementPointers;
+}
+
+void ExecutionResultBuilder::notifyTimedOut()
+{
+    mResult->mTimedOut = true;
+}
+
 void ExecutionResultBuilder::registerEventHandlersIntoResult()
 {
 
-    QPair<QWebElement*, QString> p;
-    foreach(p, mElementPointers) {
+    // MODIFIED by CH
+    bool debug = Log::hasLogLevel(DEBUG);
+
+    foreach(EventListener p, mElementPointers.listeners()) {
         if (getType(p.second) == UNKNOWN_EVENT) {
             qWarning() << "WARN: Ignoring unsupported event of type " << p.second;
             continue;
@@ -78,8 +219,10 @@ void ExecutionResultBuilder::registerEventHandlersIntoResult()
             qWarning() << "WARN: Got event handler with NULL element. Assuming document is reciever";
         }
 
-        qDebug() << "Finalizing " << p.second << "  " << p.first->tagName() << " _T: "
-                 << p.first->attribute(QString("title"));
+        if (debug) {
+            qDebug() << "Finalizing " << p.second << "  " << p.first->tagName() << " _T: "
+                     << p.first->attribute(QString("title"));
+        }
 
         EventHandlerDescriptor* handler = new EventHandlerDescriptor(this, p.first, p.second);
 
@@ -92,39 +235,109 @@ void ExecutionResultBuilder::registerEventHandlersIntoResult()
 
 }
 
+// MODIFIED by CH
+/**
+ * Collects the <input>, <textarea> and <select> elements of every frame, and the options of the
+ * selects, in one depth-first walk per frame. The element paths are kept up to date during the
+ * walk instead of being computed for each field by DOMElementDescriptor.
+ *
+ * The walk starts at <body>, as DOMElementDescriptor resolves element paths from there.
+ */
 void ExecutionResultBuilder::registerFromFieldsIntoResult()
 {
     QSet<QWebFrame*> ff = getAllFrames();
 
     foreach(QWebFrame * f, ff) {
-        QWebElementCollection inputs = f->findAllElements("input");
-        foreach(QWebElement i, inputs) {
-            FormFieldTypes fType =  getTypeFromAttr(i.attribute("type"));
-
-            if (fType == NO_INPUT)
-                { continue; }
+        QWebElement root = f->findFirstElement("body");
 
-            QSharedPointer<FormField> formf = QSharedPointer<FormField>(new FormField(fType, new DOMElementDescriptor(0, &i)));
-            mResult->mFormFields.insert(formf);
+        if (root.isNull()) {
+            continue;
         }
 
-        //Gather <textarea> elements
-        QWebElementCollection textareas = f->findAllElements("textarea");
-        foreach(QWebElement ta, textareas) {
-            QSharedPointer<FormField> taf = QSharedPointer<FormField>(new FormField(TEXT, new DOMElementDescriptor(0, &ta)));
-            mResult->mFormFields.insert(taf);
-        }
+        QWebElement element = root;
+        DomPath path;
+
+        // the select whose options are collected, and the path to it
+        QWebElement select;
+        DomPath selectPath;
+        QSet<QString> options;
+
+        while (true) {
+            QString tag = element.tagName().toLower();
+
+            if (tag == "input") {
+                FormFieldTypes fType = getTypeFromAttr(element.attribute("type"));
+
+                if (fType != NO_INPUT) {
+                    addFormField(f, fType, &element, path);
+                }
+
+            } else if (tag == "textarea") {
+                addFormField(f, TEXT, &element, path);
 
-        //Gather select tags
-        QWebElementCollection selects = f->findAllElements("select");
-        foreach(QWebElement ss, selects) {
-            QSet<QString> options = getSelectOptions(ss);
-            QSharedPointer<FormField> ssf = QSharedPointer<FormField>(new FormField(FIXED_INPUT, new DOMElementDescriptor(0, &ss), options));
-            mResult->mFormFields.insert(ssf);
+            } else if (tag == "select" && select.isNull()) {
+                select = element;
+                selectPath = path;
+                options.clear();
+
+            } else if (tag == "option" && !select.isNull()) {
+                addSelectOption(element, &options);
+            }
+
+            QWebElement child = element.firstChild();
+
+            if (!child.isNull()) {
+                element = child;
+                path.append(1);
+                continue;
+            }
+
+            // climb up until there is a next sibling, finishing the elements left on the way
+            bool done = false;
+
+            while (true) {
+                if (element == select) {
+                    addFormField(f, FIXED_INPUT, &select, selectPath, options);
+                    select = QWebElement();
+                }
+
+                if (element == root) {
+                    done = true;
+                    break;
+                }
+
+                QWebElement sibling = element.nextSibling();
+
+                if (!sibling.isNull()) {
+                    element = sibling;
+                    path.last()++;
+                    break;
+                }
+
+                element = element.parent();
+                path.removeLast();
+            }
+
+            if (done) {
+                break;
+            }
         }
     }
 }
 
+void ExecutionResultBuilder::addFormField(QWebFrame* frame, FormFieldTypes type, QWebElement* element, const DomPath& path,
+                                          QSet<QString> options)
+{
+    DOMElementDescriptor* descriptor = new DOMElementDescriptor(0, element, path);
+
+    // the path must lead back to the element, descriptors do not record the frame path, so this
+    // can only be checked in the main frame
+    Q_ASSERT(frame != mPage->mainFrame() || descriptor->getElement(mPage) == *element);
+    Q_UNUSED(frame);
+
+    mResult->mFormFields.insert(QSharedPointer<FormField>(new FormField(type, descriptor, options)));
+}
+
 QSet<QWebFrame*> ExecutionResultBuilder::getAllFrames()
 {
     QSet<QWebFrame*> res;
@@ -142,25 +355,20 @@ QSet<QWebFrame*> ExecutionResultBuilder::getAllFrames()
     return res;
 }
 
-QSet<QString> ExecutionResultBuilder::getSelectOptions(const QWebElement& e)
+void ExecutionResultBuilder::addSelectOption(const QWebElement& o, QSet<QString>* options)
 {
-    QSet<QString> res;
-    QWebElementCollection options = e.findAll("option");
-    foreach(QWebElement o, options) {
-        QString valueAttr = o.attribute("value");
+    QString valueAttr = o.attribute("value");
 
-        if (!valueAttr.isEmpty())
-            { valueAttr = o.toPlainText(); }
+    if (!valueAttr.isEmpty())
+        { valueAttr = o.toPlainText(); }
 
-        if (valueAttr.isEmpty()) {
-            Log::warning("Found empty option element in select, ignoring");
+    if (valueAttr.isEmpty()) {
+        Log::warning("Found empty option element in select, ignoring");
 //            qWarning() << "WARN: Found empty option element in select, ignoring";
-            continue;
-        }
-
-        res << valueAttr;
+        return;
     }
-    return res;
+
+    options->insert(valueAttr);
 }
 
 /** LISTENERS **/
@@ -169,30 +377,38 @@ void ExecutionResultBuilder::slEventListenerAdded(QWebElement* elem, QString eve
 {
     Q_CHECK_PTR(elem);
 
-    qDebug() << "Detected EVENTHANDLER event =" << eventName
-             << "tag =" << elem->tagName()
-             << "id =" << elem->attribute(QString("id"))
-             << "title =" << elem->attribute(QString("title"))
-             << "class =" << elem->attribute("class");
+    // MODIFIED by CH
+    // the attributes are only read if they are logged
+    if (Log::hasLogLevel(DEBUG)) {
+        qDebug() << "Detected EVENTHANDLER event =" << eventName
+                 << "tag =" << elem->tagName()
+                 << "id =" << elem->attribute(QString("id"))
+                 << "title =" << elem->attribute(QString("title"))
+                 << "class =" << elem->attribute("class");
+    }
 
     if (isNonInteractive(eventName)) {
         return;
     }
 
-    mElementPointers.append(QPair<QWebElement*, QString>(elem, eventName));
+    mElementPointers.add(elem, eventName);
 }
 
 void ExecutionResultBuilder::slEventListenerRemoved(QWebElement* elem, QString name)
 {
-    qDebug() << "Artemis removed eventhandler for event: " << name << " tag name: "
-             << elem->tagName() << " id: " << elem->attribute(QString("id")) << " title "
-             << elem->attribute(QString("title")) << "class: " << elem->attribute("class") << endl;
+    // MODIFIED by CH
+    if (Log::hasLogLevel(DEBUG)) {
+        qDebug() << "Artemis removed eventhandler for event: " << name << " tag name: "
+                 << elem->tagName() << " id: " << elem->attribute(QString("id")) << " title "
+                 << elem->attribute(QString("title")) << "class: " << elem->attribute("class") << endl;
+    }
 
     if (isNonInteractive(name)) {
         return;
     }
 
-    mElementPointers.removeAt(mElementPointers.indexOf(QPair<QWebElement*, QString>(elem, name)));
+    // listeners added before the last reset are removed as well, e.g. when the page is unloaded
+    mElementPointers.remove(elem, name);
 }
 
 void ExecutionResultBuilder::slTimerAdded(int timerId, int timeout, bool singleShot)
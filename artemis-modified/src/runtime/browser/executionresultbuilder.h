@@ -25,6 +25,8 @@
 
 #include "runtime/browser/executionresult.h"
 #include "runtime/browser/artemiswebpage.h"
+#include "runtime/browser/domstatehasher.h"
+#include "runtime/browser/eventlistenerregistry.h"
 
 namespace artemis
 {
@@ -56,18 +58,60 @@ public:
     void notifyStartingLoad();
     QSharedPointer<ExecutionResult> getResult();
 
+    // MODIFIED by CH
+    // Remembers the state right after the page was loaded, so later executions of the same loaded
+    // page (in a forked process) can start from it, see WebKitExecutor
+    void saveLoadedState();
+    void restoreLoadedState();
+
+    void notifyTimedOut();
+
+    // the serialized page is only stored in the results if requested, the state is compared by hash
+    void setKeepPageContents(bool keepPageContents);
+
+    // lists the subtrees changed by the sequence in the results, see ExecutionResult::getModifiedRegions
+    void setDiffMode(bool diffMode);
+
+    void setStateAbstraction(const DomStateAbstraction& abstraction);
+
 private:
     void registerFromFieldsIntoResult();
     void registerEventHandlersIntoResult();
 
-    QSet<QString> getSelectOptions(const QWebElement&);
+    // MODIFIED by CH
+    void addSelectOption(const QWebElement& option, QSet<QString>* options);
+    void addFormField(QWebFrame* frame, FormFieldTypes type, QWebElement* element, const DomPath& path,
+                      QSet<QString> options = QSet<QString>());
     QSet<QWebFrame*> getAllFrames();
 
+    // MODIFIED by CH
+    fingerprint_t hashPageState(DomStateTree* tree, fingerprint_t* abstractState);
+    bool hasDomAbstraction() const;
+    fingerprint_t hashAbstractPageState(fingerprint_t state);
+    QList<DomPath> toBodyPaths(const QList<DomPath>& regions) const;
+
     QSharedPointer<ExecutionResult> mResult;
     ArtemisWebPagePtr mPage;
-    QString mPageStateAfterLoad;
 
-    QList<QPair<QWebElement*, QString> > mElementPointers;
+    // MODIFIED by CH
+    fingerprint_t mPageStateAfterLoad;
+    DomStateHasher mHasher;
+    bool mKeepPageContents;
+
+    bool mDiffMode;
+    DomStateTree mTreeAfterLoad;
+    DomStateTree mTree;
+
+    DomStateAbstraction mAbstraction;
+
+    // MODIFIED by CH
+    EventListenerRegistry mElementPointers;
+
+    // MODIFIED by CH
+    ExecutionResult mLoadedResult;
+    fingerprint_t mLoadedPageState;
+    DomStateTree mLoadedTree;
+    EventListenerRegistry mLoadedElementPointers;
 
 public slots:
     void slScriptCrashed(QString cause, intptr_t sourceID, int lineNumber);
@@ -0,0 +1,71 @@
+/*
+ * Copyright 2012 Aarhus University
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "executionwatchdog.h"
+
+namespace artemis
+{
+
+ExecutionWatchdog::ExecutionWatchdog(int eventTimeout, int sequenceTimeout) :
+    mEventTimeout(eventTimeout),
+    mSequenceTimeout(sequenceTimeout),
+    mInterrupted(false)
+{
+    mSequenceTimer.start();
+    mEventTimer.invalidate();
+}
+
+void ExecutionWatchdog::startSequence()
+{
+    mSequenceTimer.restart();
+    mEventTimer.invalidate();
+    mInterrupted = false;
+}
+
+void ExecutionWatchdog::startEvent()
+{
+    mEventTimer.start();
+}
+
+bool ExecutionWatchdog::isExpired() const
+{
+    if (mSequenceTimeout > 0 && mSequenceTimer.hasExpired(mSequenceTimeout)) {
+        return true;
+    }
+
+    return mEventTimeout > 0 && mEventTimer.isValid() && mEventTimer.hasExpired(mEventTimeout);
+}
+
+int ExecutionWatchdog::remainingSequenceTime() const
+{
+    if (mSequenceTimeout <= 0) {
+        return -1;
+    }
+
+    return qMax((qint64)0, mSequenceTimeout - mSequenceTimer.elapsed());
+}
+
+void ExecutionWatchdog::notifyInterrupted()
+{
+    mInterrupted = true;
+}
+
+bool ExecutionWatchdog::wasInterrupted() const
+{
+    return mInterrupted;
+}
+
+}
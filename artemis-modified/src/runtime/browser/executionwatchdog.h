@@ -0,0 +1,66 @@
+/*
+ * Copyright 2012 Aarhus University
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef EXECUTIONWATCHDOG_H
+#define EXECUTIONWATCHDOG_H
+
+#include <QElapsedTimer>
+#include <QSharedPointer>
+
+namespace artemis
+{
+
+/**
+ * @brief The ExecutionWatchdog class
+ *
+ * Time budgets, in milliseconds of wall-clock time, for a single event and for a whole sequence
+ * including the page load. A budget of 0 is not enforced.
+ *
+ * The budgets are checked by the WebKitExecutor between inputs, and by the ArtemisWebPage when
+ * WebKit asks whether a long running script should be interrupted. WebKit only asks every several
+ * seconds, and QWebPage can not change that interval, so a script which does not return overruns
+ * its budget until the next time WebKit asks.
+ */
+class ExecutionWatchdog
+{
+
+public:
+    ExecutionWatchdog(int eventTimeout, int sequenceTimeout);
+
+    void startSequence();
+    void startEvent();
+
+    bool isExpired() const;
+
+    // milliseconds left of the sequence budget, -1 if it is not enforced
+    int remainingSequenceTime() const;
+
+    void notifyInterrupted();
+    bool wasInterrupted() const;
+
+private:
+    int mEventTimeout;
+    int mSequenceTimeout;
+
+    QElapsedTimer mSequenceTimer;
+    QElapsedTimer mEventTimer;
+    bool mInterrupted;
+};
+
+typedef QSharedPointer<ExecutionWatchdog> ExecutionWatchdogPtr;
+
+}
+
+#endif // EXECUTIONWATCHDOG_H
@@ -0,0 +1,333 @@
+/*
+ * Copyright 2012 Aarhus University
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstring>
+#include <unistd.h>
+
+#include <QCoreApplication>
+#include <QDataStream>
+#include <QDebug>
+#include <QStringList>
+
+#include "statistics/statsstorage.h"
+
+#include "instrumentationrecorder.h"
+#include "executorpool.h"
+
+namespace artemis
+{
+
+ExecutorPool::ExecutorPool(QObject* parent, AppModelPtr appmodel, JQueryListener* jqueryListener,
+                           InputSerializerPtr serializer, int numWorkers) :
+    QObject(parent),
+    mAppmodel(appmodel),
+    mJquery(jqueryListener),
+    mSerializer(serializer),
+    mNumWorkers(numWorkers),
+    mDetached(false),
+    mServer(NULL)
+{
+}
+
+ExecutorPool::~ExecutorPool()
+{
+    detach();
+    qDeleteAll(mWorkers);
+}
+
+/**
+ * Starts the worker processes. Returns false if none could be started.
+ */
+bool ExecutorPool::start()
+{
+    QString name = QString("artemis-%1").arg(getpid());
+
+    // left behind by a crashed process with the same pid
+    QLocalServer::removeServer(name);
+
+    mServer = new QLocalServer(this);
+
+    if (!mServer->listen(name)) {
+        qWarning() << "WARN: The executor pool could not listen on" << name << ":" << mServer->errorString();
+        return false;
+    }
+
+    QObject::connect(mServer, SIGNAL(newConnection()),
+                     this, SLOT(slWorkerConnected()));
+
+    QStringList arguments = QCoreApplication::arguments().mid(1);
+    arguments << "--worker" << mServer->fullServerName();
+
+    int numStarted = 0;
+
+    for (int i = 0; i < mNumWorkers; i++) {
+        QProcess* process = new QProcess(this);
+        process->setProcessChannelMode(QProcess::ForwardedChannels);
+
+        process->start(QCoreApplication::applicationFilePath(), arguments);
+
+        if (!process->waitForStarted()) {
+            qWarning() << "WARN: Worker" << i << "could not be started:" << process->errorString();
+            delete process;
+            continue;
+        }
+
+        QObject::connect(process, SIGNAL(finished(int, QProcess::ExitStatus)),
+                         this, SLOT(slProcessFinished()));
+
+        mProcesses.append(process);
+        numStarted++;
+    }
+
+    mNumWorkers = numStarted;
+    statistics()->accumulate("ExecutorPool::workers", numStarted);
+
+    return numStarted > 0;
+}
+
+/**
+ * Ends the workers, configurations without a result are dropped.
+ */
+void ExecutorPool::detach()
+{
+    if (mDetached) {
+        return;
+    }
+
+    mDetached = true;
+
+    foreach (Worker* worker, mWorkers) {
+        worker->socket->disconnect(this);
+        worker->socket->abort();
+    }
+
+    // the workers exit when their connection is closed
+    foreach (QProcess* process, mProcesses) {
+        process->disconnect(this);
+
+        if (!process->waitForFinished(5000)) {
+            process->kill();
+            process->waitForFinished();
+        }
+    }
+
+    if (mServer != NULL) {
+        mServer->close();
+    }
+}
+
+void ExecutorPool::executeSequence(ExecutableConfigurationConstPtr conf)
+{
+    mPending.append(conf);
+    dispatch();
+}
+
+int ExecutorPool::numBusy() const
+{
+    int busy = mPending.size();
+
+    foreach (Worker* worker, mWorkers) {
+        if (!worker->conf.isNull()) {
+            busy++;
+        }
+    }
+
+    return busy;
+}
+
+int ExecutorPool::numIdle() const
+{
+    return qMax(0, mNumWorkers - numBusy());
+}
+
+void ExecutorPool::writeMessage(QIODevice* device, const QByteArray& message)
+{
+    quint32 length = message.size();
+
+    device->write((const char*)&length, sizeof(length));
+    device->write(message);
+}
+
+bool ExecutorPool::takeMessage(QByteArray* buffer, QByteArray* message)
+{
+    quint32 length;
+
+    if ((size_t)buffer->size() < sizeof(length)) {
+        return false;
+    }
+
+    memcpy(&length, buffer->constData(), sizeof(length));
+
+    if ((quint32)buffer->size() - sizeof(length) < length) {
+        return false;
+    }
+
+    *message = buffer->mid(sizeof(length), length);
+    buffer->remove(0, sizeof(length) + length);
+
+    return true;
+}
+
+void ExecutorPool::dispatch()
+{
+    foreach (Worker* worker, mWorkers) {
+        if (mPending.isEmpty()) {
+            return;
+        }
+
+        if (!worker->conf.isNull()) {
+            continue;
+        }
+
+        worker->conf = mPending.takeFirst();
+
+        QByteArray message;
+        QDataStream stream(&message, QIODevice::WriteOnly);
+        mSerializer->write(stream, worker->conf);
+
+        writeMessage(worker->socket, message);
+    }
+}
+
+ExecutorPool::Worker* ExecutorPool::findWorker(QObject* socket)
+{
+    foreach (Worker* worker, mWorkers) {
+        if (worker->socket == socket) {
+            return worker;
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * A worker message is a success flag, followed by the execution result, the jQuery handlers and
+ * the instrumentation records if the execution succeeded, else by the reason it failed.
+ */
+void ExecutorPool::handleMessage(Worker* worker, const QByteArray& message)
+{
+    ExecutableConfigurationConstPtr conf = worker->conf;
+    worker->conf.clear();
+
+    if (conf.isNull()) {
+        qWarning() << "WARN: Ignoring a result from an idle worker";
+        return;
+    }
+
+    QDataStream stream(message);
+    bool ok = false;
+
+    stream >> ok;
+
+    if (!ok) {
+        QString reason;
+        stream >> reason;
+
+        emit sigAbortedExecution(reason);
+        return;
+    }
+
+    QSharedPointer<ExecutionResult> result = ExecutionResult::read(stream);
+    mJquery->read(stream);
+
+    if (stream.status() != QDataStream::Ok || !InstrumentationRecorder::replay(stream, conf, mAppmodel)) {
+        emit sigAbortedExecution(QString("Error: A worker sent a corrupt result for ") + conf->getUrl().toString());
+        return;
+    }
+
+    statistics()->accumulate("ExecutorPool::executions", 1);
+
+    // the worker continues while the result is processed
+    dispatch();
+
+    emit sigExecutedSequence(conf, result);
+}
+
+void ExecutorPool::slWorkerConnected()
+{
+    while (mServer->hasPendingConnections()) {
+        Worker* worker = new Worker();
+        worker->socket = mServer->nextPendingConnection();
+
+        QObject::connect(worker->socket, SIGNAL(readyRead()),
+                         this, SLOT(slWorkerReadyRead()));
+        QObject::connect(worker->socket, SIGNAL(disconnected()),
+                         this, SLOT(slWorkerDisconnected()));
+
+        mWorkers.append(worker);
+    }
+
+    dispatch();
+}
+
+void ExecutorPool::slWorkerReadyRead()
+{
+    QObject* socket = sender();
+    Worker* worker = findWorker(socket);
+
+    if (worker == NULL) {
+        return;
+    }
+
+    worker->buffer.append(worker->socket->readAll());
+
+    QByteArray message;
+
+    // the runtime may detach the pool, or the worker may be lost, while a result is emitted
+    while (!mDetached && (worker = findWorker(socket)) != NULL && takeMessage(&worker->buffer, &message)) {
+        handleMessage(worker, message);
+    }
+}
+
+/**
+ * A worker which disconnects ended, its configuration is handed to the next idle worker.
+ */
+void ExecutorPool::slWorkerDisconnected()
+{
+    Worker* worker = findWorker(sender());
+
+    if (worker == NULL || mDetached) {
+        return;
+    }
+
+    qWarning() << "WARN: A worker of the executor pool ended";
+    statistics()->accumulate("ExecutorPool::workers-lost", 1);
+
+    if (!worker->conf.isNull()) {
+        mPending.prepend(worker->conf);
+    }
+
+    mWorkers.removeOne(worker);
+    worker->socket->deleteLater();
+    delete worker;
+
+    dispatch();
+}
+
+void ExecutorPool::slProcessFinished()
+{
+    if (mDetached) {
+        return;
+    }
+
+    mNumWorkers--;
+
+    if (mNumWorkers <= 0) {
+        emit sigAbortedExecution(QString("Error: All workers of the executor pool ended"));
+    }
+}
+
+}
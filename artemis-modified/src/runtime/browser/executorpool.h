@@ -0,0 +1,115 @@
+/*
+ * Copyright 2012 Aarhus University
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef EXECUTORPOOL_H
+#define EXECUTORPOOL_H
+
+#include <QByteArray>
+#include <QIODevice>
+#include <QList>
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QObject>
+#include <QProcess>
+#include <QSharedPointer>
+
+#include "runtime/executableconfiguration.h"
+#include "runtime/appmodel.h"
+#include "runtime/input/inputserializer.h"
+#include "strategies/inputgenerator/targets/jquerylistener.h"
+
+#include "executionresult.h"
+
+namespace artemis
+{
+
+/**
+ * @brief The ExecutorPool class
+ *
+ * Executes configurations in worker processes, each running its own page (see ExecutorWorker).
+ * The workers are started from the artemis binary with the same arguments plus --worker, and
+ * connect back to a local server of this process.
+ *
+ * Every idle worker is handed one configuration. The worker sends back the execution result, its
+ * jQuery handlers and the recorded instrumentation, which is replayed into the app model of this
+ * process, so the worklist, the visited states and the coverage are only kept here. Results are
+ * emitted in the order they arrive; with a single worker this is the order of executeSequence.
+ *
+ * Messages in both directions are a 32 bit length followed by that many bytes.
+ */
+class ExecutorPool : public QObject
+{
+    Q_OBJECT
+
+public:
+    ExecutorPool(QObject* parent, AppModelPtr appmodel, JQueryListener* jqueryListener,
+                 InputSerializerPtr serializer, int numWorkers);
+    ~ExecutorPool();
+
+    bool start();
+    void detach();
+
+    void executeSequence(ExecutableConfigurationConstPtr conf);
+
+    // configurations handed to executeSequence without a result yet
+    int numBusy() const;
+
+    // configurations which can be handed to executeSequence before a worker has to wait
+    int numIdle() const;
+
+    static void writeMessage(QIODevice* device, const QByteArray& message);
+
+    // removes the first complete message from buffer, if there is one
+    static bool takeMessage(QByteArray* buffer, QByteArray* message);
+
+private:
+    struct Worker
+    {
+        QLocalSocket* socket;
+        QByteArray buffer;
+        ExecutableConfigurationConstPtr conf;
+    };
+
+    void dispatch();
+    Worker* findWorker(QObject* socket);
+    void handleMessage(Worker* worker, const QByteArray& message);
+
+    AppModelPtr mAppmodel;
+    JQueryListener* mJquery;
+    InputSerializerPtr mSerializer;
+    int mNumWorkers;
+    bool mDetached;
+
+    QLocalServer* mServer;
+    QList<QProcess*> mProcesses;
+    QList<Worker*> mWorkers;
+
+    // not yet handed to a worker, in the order of executeSequence
+    QList<ExecutableConfigurationConstPtr> mPending;
+
+signals:
+    void sigExecutedSequence(ExecutableConfigurationConstPtr conf, QSharedPointer<ExecutionResult> res);
+    void sigAbortedExecution(QString reason);
+
+private slots:
+    void slWorkerConnected();
+    void slWorkerReadyRead();
+    void slWorkerDisconnected();
+    void slProcessFinished();
+};
+
+}
+
+#endif // EXECUTORPOOL_H
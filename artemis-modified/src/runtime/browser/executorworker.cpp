@@ -0,0 +1,173 @@
+/*
+ * Copyright 2012 Aarhus University
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <QCoreApplication>
+#include <QDataStream>
+#include <QDebug>
+#include <QNetworkProxy>
+#include <QStringList>
+
+#include "runtime/appmodel.h"
+#include "runtime/browser/ajax/ajaxrequestlistener.h"
+#include "runtime/browser/cookies/immutablecookiejar.h"
+#include "strategies/inputgenerator/targets/targetgenerator.h"
+
+#include "executorpool.h"
+#include "executorworker.h"
+
+namespace artemis
+{
+
+/**
+ * Sets up the page as Runtime does, except that the page is always loaded for every configuration,
+ * --fork-after-load and --fork-checkpoints are not used by workers.
+ */
+ExecutorWorker::ExecutorWorker(QObject* parent, const Options& options, QUrl url) :
+    QObject(parent),
+    mSocket(NULL),
+    mRecorder(NULL)
+{
+    if (!options.useProxy.isNull()) {
+        QStringList parts = options.useProxy.split(QString(":"));
+        QNetworkProxy proxy(QNetworkProxy::HttpProxy, parts.at(0), parts.at(1).toShort());
+        QNetworkProxy::setApplicationProxy(proxy);
+    }
+
+    AjaxRequestListener* ajaxRequestListner = new AjaxRequestListener(NULL);
+    ajaxRequestListner->setCookieJar(new ImmutableCookieJar(options.presetCookies, url.host()));
+
+    if (!options.resourceCacheInclude.isEmpty()) {
+        ajaxRequestListner->setResourceCache(ResourceCachePtr(new ResourceCache(options.resourceCacheInclude,
+                                                                                options.resourceCacheExclude)));
+    }
+
+    mJquery = new JQueryListener(this);
+
+    AppModelPtr appmodel = AppModelPtr(new AppModel(options.coverageIgnoreUrls));
+
+    mWebkitExecutor = new WebKitExecutor(this, appmodel, options.presetFormfields, mJquery, ajaxRequestListner);
+    mWebkitExecutor->setAnalysisProfile(options.analysisProfile);
+    mWebkitExecutor->setTimeouts(options.eventTimeout, options.sequenceTimeout);
+    mWebkitExecutor->setKeepPageContents(!options.dumpPageStates.isNull());
+    mWebkitExecutor->setDomDiff(options.domDiff);
+
+    // only used by the state check
+    if (!options.disableStateCheck) {
+        mWebkitExecutor->setStateAbstraction(options.stateAbstraction);
+    }
+
+    QObject::connect(mWebkitExecutor, SIGNAL(sigExecutedSequence(ExecutableConfigurationConstPtr, QSharedPointer<ExecutionResult>)),
+                     this, SLOT(slExecutedSequence(ExecutableConfigurationConstPtr, QSharedPointer<ExecutionResult>)));
+    QObject::connect(mWebkitExecutor, SIGNAL(sigAbortedExecution(QString)),
+                     this, SLOT(slAbortedExecution(QString)));
+
+    mSerializer = InputSerializerPtr(new InputSerializer(new TargetGenerator(this, mJquery)));
+}
+
+ExecutorWorker::~ExecutorWorker()
+{
+    delete mRecorder;
+}
+
+bool ExecutorWorker::connectToPool(const QString& serverName)
+{
+    mSocket = new QLocalSocket(this);
+
+    QObject::connect(mSocket, SIGNAL(readyRead()),
+                     this, SLOT(slReadyRead()));
+    QObject::connect(mSocket, SIGNAL(disconnected()),
+                     this, SLOT(slDisconnected()));
+
+    mSocket->connectToServer(serverName);
+
+    if (!mSocket->waitForConnected()) {
+        qWarning() << "WARN: The worker could not connect to" << serverName << ":" << mSocket->errorString();
+        return false;
+    }
+
+    return true;
+}
+
+void ExecutorWorker::executeNext()
+{
+    QByteArray message;
+
+    if (mRecorder != NULL || !ExecutorPool::takeMessage(&mBuffer, &message)) {
+        return;
+    }
+
+    QDataStream stream(message);
+    ExecutableConfigurationConstPtr conf = mSerializer->readConfiguration(stream);
+
+    if (conf.isNull()) {
+        slAbortedExecution(QString("Error: The worker received a corrupt configuration"));
+        return;
+    }
+
+    // connected before the load, so the instrumentation of the load is recorded as well
+    mRecorder = new InstrumentationRecorder(mWebkitExecutor->webkitListener);
+    mWebkitExecutor->setRecorder(mRecorder);
+
+    mWebkitExecutor->executeSequence(conf);
+}
+
+void ExecutorWorker::finishExecution(const QByteArray& message)
+{
+    mWebkitExecutor->setRecorder(NULL);
+    delete mRecorder;
+    mRecorder = NULL;
+
+    ExecutorPool::writeMessage(mSocket, message);
+
+    executeNext();
+}
+
+void ExecutorWorker::slReadyRead()
+{
+    mBuffer.append(mSocket->readAll());
+    executeNext();
+}
+
+void ExecutorWorker::slDisconnected()
+{
+    mWebkitExecutor->detach();
+    QCoreApplication::quit();
+}
+
+void ExecutorWorker::slExecutedSequence(ExecutableConfigurationConstPtr, QSharedPointer<ExecutionResult> result)
+{
+    QByteArray message;
+    QDataStream stream(&message, QIODevice::WriteOnly);
+
+    stream << true;
+    result->write(stream);
+    mJquery->write(stream);
+    mRecorder->write(stream);
+
+    finishExecution(message);
+}
+
+void ExecutorWorker::slAbortedExecution(QString reason)
+{
+    QByteArray message;
+    QDataStream stream(&message, QIODevice::WriteOnly);
+
+    stream << false << reason;
+
+    finishExecution(message);
+}
+
+}
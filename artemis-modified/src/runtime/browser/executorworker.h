@@ -0,0 +1,75 @@
+/*
+ * Copyright 2012 Aarhus University
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef EXECUTORWORKER_H
+#define EXECUTORWORKER_H
+
+#include <QByteArray>
+#include <QLocalSocket>
+#include <QObject>
+#include <QUrl>
+
+#include "runtime/options.h"
+#include "runtime/input/inputserializer.h"
+#include "strategies/inputgenerator/targets/jquerylistener.h"
+
+#include "executionresult.h"
+#include "instrumentationrecorder.h"
+#include "webkitexecutor.h"
+
+namespace artemis
+{
+
+/**
+ * @brief The ExecutorWorker class
+ *
+ * The main object of a worker process of an ExecutorPool. Executes the configurations received
+ * from the pool one at a time, loading the page for each of them, and sends back the result and the
+ * instrumentation recorded during the execution. The process ends when the pool disconnects.
+ */
+class ExecutorWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    ExecutorWorker(QObject* parent, const Options& options, QUrl url);
+    ~ExecutorWorker();
+
+    bool connectToPool(const QString& serverName);
+
+private:
+    void executeNext();
+    void finishExecution(const QByteArray& message);
+
+    WebKitExecutor* mWebkitExecutor;
+    JQueryListener* mJquery;
+    InputSerializerPtr mSerializer;
+
+    QLocalSocket* mSocket;
+    QByteArray mBuffer;
+
+    // set while a configuration is executed
+    InstrumentationRecorder* mRecorder;
+
+private slots:
+    void slReadyRead();
+    void slDisconnected();
+    void slExecutedSequence(ExecutableConfigurationConstPtr conf, QSharedPointer<ExecutionResult> result);
+    void slAbortedExecution(QString reason);
+};
+
+}
+
+#endif // EXECUTORWORKER_H
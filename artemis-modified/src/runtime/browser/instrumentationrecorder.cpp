@@ -0,0 +1,206 @@
+/*
+ * Copyright 2012 Aarhus University
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <QDebug>
+
+#include "instrumentationrecorder.h"
+
+namespace artemis
+{
+
+InstrumentationRecorder::InstrumentationRecorder(QWebExecutionListener* webkitListener) :
+    QObject(NULL)
+{
+    QObject::connect(webkitListener, SIGNAL(loadedJavaScript(QString, QUrl, uint)),
+                     this, SLOT(slJavascriptScriptParsed(QString, QUrl, uint)));
+    QObject::connect(webkitListener, SIGNAL(statementExecuted(uint, QUrl, uint)),
+                     this, SLOT(slJavascriptStatementExecuted(uint, QUrl, uint)));
+    QObject::connect(webkitListener, SIGNAL(sigJavascriptBytecodeExecuted(uint,  uint, QUrl, uint)),
+                     this, SLOT(slJavascriptBytecodeExecuted(uint, uint, QUrl, uint)));
+    QObject::connect(webkitListener, SIGNAL(sigJavascriptFunctionCalled(QString, size_t, uint, QUrl, uint)),
+                     this, SLOT(slJavascriptFunctionCalled(QString, size_t, uint, QUrl, uint)));
+
+    QObject::connect(webkitListener, SIGNAL(sigJavascriptPropertyRead(QString,intptr_t,intptr_t,QUrl,int)),
+                     this, SLOT(slJavascriptPropertyRead(QString,intptr_t,intptr_t,QUrl,int)));
+    QObject::connect(webkitListener, SIGNAL(sigJavascriptPropertyWritten(QString,intptr_t,intptr_t,QUrl,int)),
+                     this, SLOT(slJavascriptPropertyWritten(QString,intptr_t,intptr_t,QUrl,int)));
+}
+
+void InstrumentationRecorder::notifyStartingEvent(int index)
+{
+    mSeenInEvent.clear();
+
+    QDataStream stream(&mRecords, QIODevice::WriteOnly | QIODevice::Append);
+    stream << (quint8)STARTING_EVENT << (qint32)index;
+}
+
+void InstrumentationRecorder::record(const QByteArray& record)
+{
+    if (mSeenInEvent.contains(record)) {
+        return;
+    }
+
+    mSeenInEvent.insert(record);
+    mRecords.append(record);
+}
+
+void InstrumentationRecorder::write(QDataStream& stream) const
+{
+    stream.writeRawData(mRecords.constData(), mRecords.size());
+    stream << (quint8)END_OF_RECORDS;
+}
+
+/**
+ * Feeds the records written by write into the listeners of appmodel, as if the sequence had been
+ * executed in this process. Returns false if the records are corrupt.
+ */
+bool InstrumentationRecorder::replay(QDataStream& stream, ExecutableConfigurationConstPtr configuration, AppModelPtr appmodel)
+{
+    CoverageListenerPtr coverage = appmodel->getCoverageListener();
+    JavascriptStatisticsPtr javascriptStatistics = appmodel->getJavascriptStatistics();
+
+    QList<QSharedPointer<const BaseInput> > inputs;
+
+    foreach (QSharedPointer<const BaseInput> input, *configuration->getInputSequence()) {
+        inputs.append(input);
+    }
+
+    coverage->notifyStartingLoad();
+    javascriptStatistics->notifyStartingLoad();
+
+    while (stream.status() == QDataStream::Ok) {
+        quint8 type;
+        stream >> type;
+
+        QString name;
+        QUrl url;
+        quint32 first;
+        quint32 second;
+        quint32 startLine;
+        quint64 size;
+
+        switch (type) {
+        case STARTING_EVENT: {
+            qint32 index;
+            stream >> index;
+
+            if (index < 0 || index >= inputs.size()) {
+                return false;
+            }
+
+            coverage->notifyStartingEvent(inputs.at(index));
+            javascriptStatistics->notifyStartingEvent(inputs.at(index));
+            break;
+        }
+
+        case SCRIPT_PARSED:
+            stream >> name >> url >> startLine;
+            coverage->slJavascriptScriptParsed(name, url, startLine);
+            break;
+
+        case FUNCTION_CALLED:
+            stream >> name >> size >> first >> url >> startLine;
+            coverage->slJavascriptFunctionCalled(name, size, first, url, startLine);
+            break;
+
+        case BYTECODE_EXECUTED:
+            stream >> first >> second >> url >> startLine;
+            coverage->slJavascriptBytecodeExecuted(first, second, url, startLine);
+            break;
+
+        case STATEMENT_EXECUTED:
+            stream >> first >> url >> startLine;
+            coverage->slJavascriptStatementExecuted(first, url, startLine);
+            break;
+
+        case PROPERTY_READ:
+            stream >> name >> url >> first;
+            javascriptStatistics->slJavascriptPropertyRead(name, 0, 0, url, first);
+            break;
+
+        case PROPERTY_WRITTEN:
+            stream >> name >> url >> first;
+            javascriptStatistics->slJavascriptPropertyWritten(name, 0, 0, url, first);
+            break;
+
+        case END_OF_RECORDS:
+            coverage->flush();
+            return true;
+
+        default:
+            qWarning() << "InstrumentationRecorder: unknown record type" << type;
+            return false;
+        }
+    }
+
+    return false;
+}
+
+void InstrumentationRecorder::slJavascriptScriptParsed(QString sourceCode, QUrl sourceUrl, uint sourceStartLine)
+{
+    QByteArray bytes;
+    QDataStream stream(&bytes, QIODevice::WriteOnly);
+    stream << (quint8)SCRIPT_PARSED << sourceCode << sourceUrl << (quint32)sourceStartLine;
+
+    record(bytes);
+}
+
+void InstrumentationRecorder::slJavascriptFunctionCalled(QString functionName, size_t bytecodeSize, uint sourceOffset, QUrl sourceUrl, uint sourceStartLine)
+{
+    QByteArray bytes;
+    QDataStream stream(&bytes, QIODevice::WriteOnly);
+    stream << (quint8)FUNCTION_CALLED << functionName << (quint64)bytecodeSize << (quint32)sourceOffset << sourceUrl << (quint32)sourceStartLine;
+
+    record(bytes);
+}
+
+void InstrumentationRecorder::slJavascriptBytecodeExecuted(uint bytecodeOffset, uint sourceOffset, QUrl sourceUrl, uint sourceStartLine)
+{
+    QByteArray bytes;
+    QDataStream stream(&bytes, QIODevice::WriteOnly);
+    stream << (quint8)BYTECODE_EXECUTED << (quint32)bytecodeOffset << (quint32)sourceOffset << sourceUrl << (quint32)sourceStartLine;
+
+    record(bytes);
+}
+
+void InstrumentationRecorder::slJavascriptStatementExecuted(uint linenumber, QUrl sourceUrl, uint sourceStartLine)
+{
+    QByteArray bytes;
+    QDataStream stream(&bytes, QIODevice::WriteOnly);
+    stream << (quint8)STATEMENT_EXECUTED << (quint32)linenumber << sourceUrl << (quint32)sourceStartLine;
+
+    record(bytes);
+}
+
+void InstrumentationRecorder::slJavascriptPropertyRead(QString propertyName, intptr_t, intptr_t, QUrl url, int line)
+{
+    QByteArray bytes;
+    QDataStream stream(&bytes, QIODevice::WriteOnly);
+    stream << (quint8)PROPERTY_READ << propertyName << url << (quint32)line;
+
+    record(bytes);
+}
+
+void InstrumentationRecorder::slJavascriptPropertyWritten(QString propertyName, intptr_t, intptr_t, QUrl url, int line)
+{
+    QByteArray bytes;
+    QDataStream stream(&bytes, QIODevice::WriteOnly);
+    stream << (quint8)PROPERTY_WRITTEN << propertyName << url << (quint32)line;
+
+    record(bytes);
+}
+
+}
@@ -0,0 +1,80 @@
+/*
+ * Copyright 2012 Aarhus University
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef INSTRUMENTATIONRECORDER_H
+#define INSTRUMENTATIONRECORDER_H
+
+#include <inttypes.h>
+
+#include <QObject>
+#include <QByteArray>
+#include <QDataStream>
+#include <QSet>
+#include <QUrl>
+#include <QtWebKit/qwebexecutionlistener.h>
+
+#include "runtime/executableconfiguration.h"
+#include "runtime/appmodel.h"
+
+namespace artemis
+{
+
+/**
+ * @brief The InstrumentationRecorder class
+ *
+ * Records the instrumentation signals consumed by the CoverageListener and JavascriptStatistics
+ * while a sequence is executed in another process, so the parent can replay them into its own
+ * AppModel.
+ *
+ * All listener slots are idempotent within one event, so repeated records (e.g. a bytecode
+ * executed in a loop) are only stored once per event.
+ */
+class InstrumentationRecorder : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit InstrumentationRecorder(QWebExecutionListener* webkitListener);
+
+    // index of the input of the sequence which is about to be applied
+    void notifyStartingEvent(int index);
+
+    void write(QDataStream& stream) const;
+
+    static bool replay(QDataStream& stream, ExecutableConfigurationConstPtr configuration, AppModelPtr appmodel);
+
+private:
+    enum RecordTypes {
+        STARTING_EVENT, SCRIPT_PARSED, FUNCTION_CALLED, BYTECODE_EXECUTED, STATEMENT_EXECUTED,
+        PROPERTY_READ, PROPERTY_WRITTEN, END_OF_RECORDS
+    };
+
+    void record(const QByteArray& record);
+
+    QByteArray mRecords;
+    QSet<QByteArray> mSeenInEvent;
+
+private slots:
+    void slJavascriptScriptParsed(QString sourceCode, QUrl sourceUrl, uint sourceStartLine);
+    void slJavascriptFunctionCalled(QString functionName, size_t bytecodeSize, uint sourceOffset, QUrl sourceUrl, uint sourceStartLine);
+    void slJavascriptBytecodeExecuted(uint bytecodeOffset, uint sourceOffset, QUrl sourceUrl, uint sourceStartLine);
+    void slJavascriptStatementExecuted(uint linenumber, QUrl sourceUrl, uint sourceStartLine);
+    void slJavascriptPropertyRead(QString propertyName, intptr_t codeBlockID, intptr_t sourceID, QUrl url, int line);
+    void slJavascriptPropertyWritten(QString propertyName, intptr_t codeBlockID, intptr_t sourceID, QUrl url, int line);
+};
+
+}
+
+#endif // INSTRUMENTATIONRECORDER_H
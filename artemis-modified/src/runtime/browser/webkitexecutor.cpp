@@ -15,12 +15,19 @@
  */
 
 #include <iostream>
+#include <cstdio>
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
 #include <unistd.h>
+#include <sys/wait.h>
 
 #include <QtWebKit>
 #include <QApplication>
 #include <QStack>
 #include <QDebug>
+#include <QFile>
+#include <QTimer>
 #include <qwebexecutionlistener.h>
 #include <instrumentation/executionlistener.h>
 
@@ -28,6 +35,9 @@
 #include "runtime/input/events/domelementdescriptor.h"
 #include "strategies/inputgenerator/targets/jquerylistener.h"
 #include "runtime/input/baseinput.h"
+#include "statistics/statsstorage.h"
+#include "util/fingerprintutil.h"
+#include "util/randomutil.h"
 
 #include "webkitexecutor.h"
 
@@ -40,8 +50,16 @@ WebKitExecutor::WebKitExecutor(QObject* parent,
                                AppModelPtr appmodel,
                                QMap<QString, QString> presetFields,
                                JQueryListener* jqueryListener,
-                               AjaxRequestListener* ajaxListener) :
-    QObject(parent)
+                               AjaxRequestListener* ajaxListener,
+                               bool forkAfterLoad) :
+    QObject(parent),
+    mAppmodel(appmodel),
+    mForkAfterLoad(forkAfterLoad),
+    mLoadedPageReady(false),
+    mRecorder(NULL),
+    mCoordinator(0),
+    mLoadTimer(NULL),
+    mLoadTimedOut(false)
 {
 
     mPresetFields = presetFields;
@@ -116,12 +134,30 @@ void WebKitExecutor::detach() {
     // ignore events emitted from webkit on deallocation
     webkitListener->disconnect(mResultBuilder.data());
 
+    // MODIFIED by CH
+    // ends the checkpoint processes
+    mCheckpoints.clear();
+
 }
 
 void WebKitExecutor::executeSequence(ExecutableConfigurationConstPtr conf)
 {
     currentConf = conf;
 
+    // MODIFIED by CH
+    if (mLoadedPageReady && conf->getUrl() == mLoadedPageUrl) {
+
+        if (executeForked(conf)) {
+            return;
+        }
+
+        // the page is loaded again below, and the inputs applied to it
+        qWarning() << "WARN: Forked execution failed, loading the page for every sequence from now on";
+        mLoadedPageReady = false;
+        mForkAfterLoad = false;
+        mCheckpoints.clear();
+    }
+
     mJquery->reset(); // TODO merge into result?
     mResultBuilder->reset();
 
@@ -131,13 +167,45 @@ void WebKitExecutor::executeSequence(ExecutableConfigurationConstPtr conf)
     mResultBuilder->notifyStartingLoad();
     mJavascriptStatistics->notifyStartingLoad();
 
+    // MODIFIED by CH
+    if (!mWatchdog.isNull()) {
+        mWatchdog->startSequence();
+        mLoadTimedOut = false;
+
+        if (mWatchdog->remainingSequenceTime() >= 0) {
+            mLoadTimer->start(mWatchdog->remainingSequenceTime());
+        }
+    }
+
     mPage->mainFrame()->load(conf->getUrl());
 }
 
+// MODIFIED by CH
+void WebKitExecutor::slLoadTimedOut()
+{
+    qWarning() << "WARN: Stopping the page load, the sequence timeout was exceeded";
+
+    mLoadTimedOut = true;
+    mPage->triggerAction(QWebPage::Stop);
+}
+
 void WebKitExecutor::slLoadFinished(bool ok)
 {
     mResultBuilder->notifyPageLoaded();
 
+    // MODIFIED by CH
+    if (!mWatchdog.isNull()) {
+        mLoadTimer->stop();
+    }
+
+    if (!ok && mLoadTimedOut) {
+        statistics()->accumulate("WebKitExecutor::timed-out", 1);
+        mResultBuilder->notifyTimedOut();
+
+        emit sigExecutedSequence(currentConf, mResultBuilder->getResult());
+        return;
+    }
+
     if (!ok) {
         emit sigAbortedExecution(QString("Error: The requested URL ") + currentConf->getUrl().toString() + QString(" could not be loaded"));
         return;
@@ -156,20 +224,421 @@ void WebKitExecutor::slLoadFinished(bool ok)
         elm.setAttribute("value", mPresetFields[f]);
     }
 
+    // MODIFIED by CH
+    if (mForkAfterLoad && currentConf->isInitial()) {
+        saveCheckpointState();
+        mLoadedPageReady = true;
+        mLoadedPageUrl = currentConf->getUrl();
+    }
+
     // Execute input sequence
 
+    QList<QSharedPointer<const BaseInput> > inputs;
+
+    foreach(QSharedPointer<const BaseInput> input, *currentConf->getInputSequence()) {
+        inputs.append(input);
+    }
+
+    executeInputs(inputs, 0, mRecorder);
+
+    // DONE
+
+    emit sigExecutedSequence(currentConf, mResultBuilder->getResult());
+}
+
+void WebKitExecutor::executeInputs(const QList<QSharedPointer<const BaseInput> >& inputs, int startIndex,
+                                   InstrumentationRecorder* recorder)
+{
     qDebug() << "\n------------ EXECUTE SEQUENCE -----------" << endl;
 
-    foreach(QSharedPointer<const BaseInput> input, currentConf->getInputSequence()->toList()) {
+    int index = startIndex;
+
+    foreach(QSharedPointer<const BaseInput> input, inputs) {
+        // MODIFIED by CH
+        if (isTimedOut()) {
+            break;
+        }
+
+        if (recorder != NULL) {
+            recorder->notifyStartingEvent(index);
+        }
+
+        // MODIFIED by CH
+        // the target choice only depends on the input and its position, also when replayed or resumed
+        seedTargetRandom((uint)fingerprintCombine(input->fingerprint(), index));
+        index++;
+
         mResultBuilder->notifyStartingEvent();
         mCoverageListener->notifyStartingEvent(input);
         mJavascriptStatistics->notifyStartingEvent(input);
+
+        // MODIFIED by CH
+        if (!mWatchdog.isNull()) {
+            mWatchdog->startEvent();
+        }
+
         input->apply(this->mPage, this->webkitListener);
     }
 
-    // DONE
+    // MODIFIED by CH
+    if (isTimedOut()) {
+        statistics()->accumulate("WebKitExecutor::timed-out", 1);
+        mResultBuilder->notifyTimedOut();
+    }
 
-    emit sigExecutedSequence(currentConf, mResultBuilder->getResult());
+    mCoverageListener->flush();
+}
+
+// MODIFIED by CH
+void WebKitExecutor::enableCheckpoints(int maxCheckpoints, InputSerializerPtr serializer)
+{
+    if (maxCheckpoints <= 0 || pipe(mResultPipe) != 0) {
+        return;
+    }
+
+    // a checkpoint may end at any time, writing to its pipe must not end this process
+    signal(SIGPIPE, SIG_IGN);
+
+    mCheckpoints = QSharedPointer<CheckpointTable>(new CheckpointTable(maxCheckpoints));
+    mSerializer = serializer;
+    mCoordinator = getpid();
+}
+
+/**
+ * Called after a reply could not be read from mResultPipe. Part of it may still be in the pipe, so
+ * the next reply would be read out of sync. All checkpoints are ended, as they reply on the old
+ * pipe, and a new one is created. Checkpoints are disabled if that fails.
+ */
+bool WebKitExecutor::resetResultPipe()
+{
+    statistics()->accumulate("WebKitExecutor::result-pipe-resets", 1);
+
+    mCheckpoints->clear();
+
+    close(mResultPipe[0]);
+    close(mResultPipe[1]);
+
+    if (pipe(mResultPipe) != 0) {
+        qWarning() << "WARN: Could not create the checkpoint result pipe, disabling checkpoints";
+        mCheckpoints.clear();
+        return false;
+    }
+
+    return true;
+}
+
+void WebKitExecutor::setRecorder(InstrumentationRecorder* recorder)
+{
+    mRecorder = recorder;
+}
+
+void WebKitExecutor::setAnalysisProfile(AnalysisProfiles profile)
+{
+    mPage->setAnalysisProfile(profile);
+}
+
+void WebKitExecutor::setKeepPageContents(bool keepPageContents)
+{
+    mResultBuilder->setKeepPageContents(keepPageContents);
+}
+
+void WebKitExecutor::setDomDiff(bool domDiff)
+{
+    mResultBuilder->setDiffMode(domDiff);
+}
+
+void WebKitExecutor::setStateAbstraction(const DomStateAbstraction& abstraction)
+{
+    mResultBuilder->setStateAbstraction(abstraction);
+}
+
+void WebKitExecutor::setTimeouts(int eventTimeout, int sequenceTimeout)
+{
+    if (eventTimeout <= 0 && sequenceTimeout <= 0) {
+        return;
+    }
+
+    mWatchdog = ExecutionWatchdogPtr(new ExecutionWatchdog(eventTimeout, sequenceTimeout));
+    mPage->setWatchdog(mWatchdog);
+
+    mLoadTimer = new QTimer(this);
+    mLoadTimer->setSingleShot(true);
+
+    QObject::connect(mLoadTimer, SIGNAL(timeout()),
+                     this, SLOT(slLoadTimedOut()));
+}
+
+/**
+ * True if a budget of the watchdog was exceeded, or a script was interrupted, since the sequence
+ * was started. The remaining inputs are not applied then.
+ */
+bool WebKitExecutor::isTimedOut() const
+{
+    return !mWatchdog.isNull() && (mWatchdog->isExpired() || mWatchdog->wasInterrupted());
+}
+
+void WebKitExecutor::saveCheckpointState()
+{
+    mResultBuilder->saveLoadedState();
+
+    mCheckpointJquery.clear();
+    QDataStream stream(&mCheckpointJquery, QIODevice::WriteOnly);
+    mJquery->write(stream);
+}
+
+void WebKitExecutor::restoreCheckpointState()
+{
+    mResultBuilder->restoreLoadedState();
+
+    QDataStream stream(mCheckpointJquery);
+    mJquery->read(stream);
+}
+
+static bool isSuccess(const QByteArray& message)
+{
+    return !message.isEmpty() && message.at(0) != 0;
+}
+
+/**
+ * Runs conf in a child process forked from the loaded page, or from the checkpoint of its longest
+ * prefix, and merges the instrumentation it recorded into the app model. Returns false if no
+ * result was received, nothing is emitted then.
+ */
+bool WebKitExecutor::executeForked(ExecutableConfigurationConstPtr conf)
+{
+    QList<QSharedPointer<const BaseInput> > inputs;
+
+    foreach (QSharedPointer<const BaseInput> input, *conf->getInputSequence()) {
+        inputs.append(input);
+    }
+
+    QString fifo = mCheckpoints.isNull() ? QString() : mCheckpoints->reserve();
+    QByteArray message;
+
+    fingerprint_t prefix;
+    int prefixLength;
+
+    if (!mCheckpoints.isNull() && mCheckpoints->find(conf->getInputSequence(), &prefix, &prefixLength)) {
+        QByteArray command;
+        QDataStream stream(&command, QIODevice::WriteOnly);
+        stream << (quint8)CHECKPOINT_EXECUTE << fifo << (qint32)prefixLength << (quint32)(inputs.size() - prefixLength);
+
+        for (int i = prefixLength; i < inputs.size(); i++) {
+            mSerializer->write(stream, inputs.at(i));
+        }
+
+        bool sent = mCheckpoints->send(prefix, command);
+        bool received = sent && CheckpointTable::readMessage(mResultPipe[0], &message, mCheckpoints->pid(prefix));
+
+        if (received && isSuccess(message)) {
+            statistics()->accumulate("WebKitExecutor::checkpoint-hits", 1);
+            statistics()->accumulate("WebKitExecutor::inputs-skipped", prefixLength);
+        } else if (sent && !received) {
+            // start over from the loaded page, the checkpoint which failed may have used the fifo
+            mCheckpoints->release(fifo);
+            message.clear();
+
+            if (resetResultPipe()) {
+                fifo = mCheckpoints->reserve();
+            } else {
+                fifo.clear();
+            }
+        } else {
+            // start over from the loaded page
+            mCheckpoints->remove(prefix);
+            message.clear();
+        }
+    }
+
+    if (message.isEmpty()) {
+        message = forkAndExecute(inputs, 0, fifo);
+    }
+
+    QDataStream stream(message);
+    bool ok = false;
+    qint64 pid = 0;
+
+    stream >> ok >> pid;
+
+    QSharedPointer<ExecutionResult> result = ExecutionResult::read(stream);
+
+    if (ok && stream.status() == QDataStream::Ok) {
+        mJquery->read(stream);
+        ok = InstrumentationRecorder::replay(stream, conf, mAppmodel);
+    }
+
+    if (!ok || stream.status() != QDataStream::Ok) {
+        statistics()->accumulate("WebKitExecutor::forked-failed", 1);
+
+        // the child may already serve as checkpoint, it would never be sent a command
+        if (!mCheckpoints.isNull()) {
+            mCheckpoints->discard((pid_t)pid, fifo);
+        }
+
+        return false;
+    }
+
+    statistics()->accumulate("WebKitExecutor::forked-executions", 1);
+
+    if (!fifo.isEmpty()) {
+        mCheckpoints->add(conf->getInputSequence()->getFingerprint(), pid, fifo);
+    }
+
+    // emitted from the event loop, as for loaded pages, so the runtime does not recurse
+    mForkedResult = result;
+    QTimer::singleShot(0, this, SLOT(slForkedExecutionFinished()));
+
+    return true;
+}
+
+/**
+ * Forks, applies inputs in the child, starting from the state saved by saveCheckpointState, and
+ * returns the message the child sent back, or an empty message if it failed.
+ *
+ * The child keeps serving as the checkpoint of the executed sequence if fifo is set, else it exits.
+ */
+QByteArray WebKitExecutor::forkAndExecute(const QList<QSharedPointer<const BaseInput> >& inputs, int startIndex,
+                                          const QString& fifo)
+{
+    int fds[2];
+
+    if (pipe(fds) != 0) {
+        return QByteArray();
+    }
+
+    // anything still buffered would be written by both processes
+    cout.flush();
+    fflush(stdout);
+    fflush(stderr);
+
+    pid_t pid = fork();
+
+    if (pid < 0) {
+        close(fds[0]);
+        close(fds[1]);
+        return QByteArray();
+    }
+
+    if (pid == 0) {
+        close(fds[0]);
+
+        // opened before the result is sent, so the parent can open it for writing without blocking
+        int commandFd = fifo.isEmpty() ? -1 : open(QFile::encodeName(fifo).constData(), O_RDWR);
+
+        InstrumentationRecorder recorder(webkitListener);
+
+        if (!mWatchdog.isNull()) {
+            mWatchdog->startSequence();
+        }
+
+        restoreCheckpointState();
+        executeInputs(inputs, startIndex, &recorder);
+        saveCheckpointState();
+
+        QByteArray message;
+        QDataStream stream(&message, QIODevice::WriteOnly);
+
+        stream << true << (qint64)getpid();
+        mResultBuilder->getResult()->write(stream);
+        mJquery->write(stream);
+        recorder.write(stream);
+
+        bool sent = CheckpointTable::writeMessage(fds[1], message);
+        close(fds[1]);
+
+        if (!sent || commandFd < 0) {
+            // skip destructors and atexit handlers, they belong to the parent
+            _exit(sent ? 0 : 1);
+        }
+
+        webkitListener->disconnect(&recorder);
+        serveCheckpoint(commandFd);
+    }
+
+    close(fds[1]);
+
+    QByteArray message;
+    bool received = CheckpointTable::readMessage(fds[0], &message, pid);
+
+    close(fds[0]);
+
+    if (!received) {
+        // the child may be stuck, e.g. after a partial message
+        kill(pid, SIGKILL);
+    }
+
+    if (!received || fifo.isEmpty()) {
+        waitpid(pid, NULL, 0);
+    }
+
+    return received ? message : QByteArray();
+}
+
+/**
+ * Command loop of a checkpoint process. Every execute command is run in a child of the checkpoint,
+ * whose result is passed on to the coordinator. Does not return.
+ */
+void WebKitExecutor::serveCheckpoint(int commandFd)
+{
+    while (true) {
+        QByteArray command;
+
+        if (!CheckpointTable::readMessage(commandFd, &command, mCoordinator)) {
+            _exit(0);
+        }
+
+        // children which ended as checkpoints
+        while (waitpid(-1, NULL, WNOHANG) > 0) {
+        }
+
+        QDataStream stream(command);
+        quint8 type;
+        stream >> type;
+
+        if (type != CHECKPOINT_EXECUTE) {
+            _exit(0);
+        }
+
+        QString fifo;
+        qint32 startIndex;
+        quint32 size;
+        stream >> fifo >> startIndex >> size;
+
+        QList<QSharedPointer<const BaseInput> > inputs;
+
+        for (quint32 i = 0; i < size; i++) {
+            QSharedPointer<const BaseInput> input = mSerializer->readInput(stream);
+
+            if (input.isNull()) {
+                break;
+            }
+
+            inputs.append(input);
+        }
+
+        QByteArray reply;
+
+        if (inputs.size() == (int)size) {
+            reply = forkAndExecute(inputs, startIndex, fifo);
+        }
+
+        if (reply.isEmpty()) {
+            QDataStream failure(&reply, QIODevice::WriteOnly);
+            failure << false;
+        }
+
+        if (!CheckpointTable::writeMessage(mResultPipe[1], reply)) {
+            _exit(0);
+        }
+    }
+}
+
+void WebKitExecutor::slForkedExecutionFinished()
+{
+    QSharedPointer<ExecutionResult> result = mForkedResult;
+    mForkedResult.clear();
+
+    emit sigExecutedSequence(currentConf, result);
 }
 
 }
@@ -22,6 +22,7 @@
 #include <QtWebKit>
 #include <QtWebKit/qwebexecutionlistener.h>
 #include <QSharedPointer>
+#include <QTimer>
 
 #include "artemisglobals.h"
 
@@ -32,12 +33,31 @@
 
 #include "executionresult.h"
 #include "executionresultbuilder.h"
+#include "checkpointtable.h"
+#include "executionwatchdog.h"
+#include "instrumentationrecorder.h"
 #include "artemiswebpage.h"
 #include "runtime/appmodel.h"
+#include "runtime/input/inputserializer.h"
 
 namespace artemis
 {
 
+/**
+ * @brief The WebKitExecutor class
+ *
+ * Executes a configuration by loading its url and applying its inputs.
+ *
+ * With forkAfterLoad the page is only loaded once, by the initial configuration. Every later
+ * configuration with the same url runs in a child process forked from the loaded page, which sends
+ * the execution result and the recorded instrumentation back over a pipe. The loaded page in this
+ * process is never modified by inputs.
+ *
+ * With enableCheckpoints these children do not exit after sending their result, they stay as
+ * checkpoints of the sequence they executed (see CheckpointTable). A configuration is then started
+ * from the checkpoint of its longest executed prefix and only its remaining inputs are applied,
+ * e.g. only the last one for configurations extending an executed configuration.
+ */
 class WebKitExecutor : public QObject
 {
     Q_OBJECT
@@ -47,15 +67,46 @@ public:
                    AppModelPtr appmodel,
                    QMap<QString, QString> presetFields,
                    JQueryListener* jqueryListener,
-                   AjaxRequestListener* ajaxListener);
+                   AjaxRequestListener* ajaxListener,
+                   bool forkAfterLoad = false);
     ~WebKitExecutor();
 
     void executeSequence(ExecutableConfigurationConstPtr conf);
     void detach();
 
+    // MODIFIED by CH
+    void enableCheckpoints(int maxCheckpoints, InputSerializerPtr serializer);
+
+    // records the events of loaded pages, see ExecutorWorker
+    void setRecorder(InstrumentationRecorder* recorder);
+
+    void setAnalysisProfile(AnalysisProfiles profile);
+
+    // in milliseconds, 0 is no limit, see ExecutionWatchdog
+    void setTimeouts(int eventTimeout, int sequenceTimeout);
+
+    void setKeepPageContents(bool keepPageContents);
+    void setDomDiff(bool domDiff);
+    void setStateAbstraction(const DomStateAbstraction& abstraction);
+
     QWebExecutionListener* webkitListener; // TODO should not be public
 
 private:
+    // MODIFIED by CH
+    void executeInputs(const QList<QSharedPointer<const BaseInput> >& inputs, int startIndex,
+                       InstrumentationRecorder* recorder);
+
+    bool executeForked(ExecutableConfigurationConstPtr conf);
+    QByteArray forkAndExecute(const QList<QSharedPointer<const BaseInput> >& inputs, int startIndex,
+                              const QString& fifo);
+    void serveCheckpoint(int commandFd);
+    bool resetResultPipe();
+
+    void saveCheckpointState();
+    void restoreCheckpointState();
+
+    bool isTimedOut() const;
+
     ArtemisWebPagePtr mPage;
     ExecutionResultBuilderPtr mResultBuilder;
     ExecutableConfigurationConstPtr currentConf;
@@ -66,6 +117,28 @@ private:
     CoverageListenerPtr mCoverageListener;
     JavascriptStatisticsPtr mJavascriptStatistics;
 
+    // MODIFIED by CH
+    AppModelPtr mAppmodel;
+    bool mForkAfterLoad;
+    bool mLoadedPageReady;
+    QUrl mLoadedPageUrl;
+    QSharedPointer<ExecutionResult> mForkedResult;
+    InstrumentationRecorder* mRecorder;
+
+    // jQuery handlers at the saved state, see saveCheckpointState
+    QByteArray mCheckpointJquery;
+
+    QSharedPointer<CheckpointTable> mCheckpoints;
+    InputSerializerPtr mSerializer;
+    pid_t mCoordinator;
+
+    // checkpoints -> coordinator, read by the coordinator only
+    int mResultPipe[2];
+
+    ExecutionWatchdogPtr mWatchdog;
+    QTimer* mLoadTimer;
+    bool mLoadTimedOut;
+
 signals:
     void sigExecutedSequence(ExecutableConfigurationConstPtr conf, QSharedPointer<ExecutionResult> res);
     void sigAbortedExecution(QString reason);
@@ -73,6 +146,10 @@ signals:
 public slots:
     void slLoadFinished(bool ok);
 
+private slots:
+    void slForkedExecutionFinished();
+    void slLoadTimedOut();
+
 
 };
 
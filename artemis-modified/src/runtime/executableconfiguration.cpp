@@ -55,6 +55,11 @@ QString ExecutableConfiguration::getLastSequence() const
     return mSequence->getLast()->toString();
 }
 
+fingerprint_t ExecutableConfiguration::getFingerprint() const
+{
+    return mSequence->getFingerprint();
+}
+
 }
 
 
@@ -40,6 +40,7 @@ public:
     // MODIFIED by CH
     QString getSequence() const;
     QString getLastSequence() const;
+    fingerprint_t getFingerprint() const;
 
 private:
     const QUrl mUrl;
@@ -58,4 +58,14 @@ QString AjaxInput::getSequence() const
     return QString("AjaxInput");
 }
 
+fingerprint_t AjaxInput::fingerprint() const
+{
+    return fingerprintCombine(7, mCallbackId);
+}
+
+void AjaxInput::write(QDataStream& stream) const
+{
+    stream << (quint8)AJAX_INPUT << (qint32)mCallbackId;
+}
+
 }
@@ -18,15 +18,23 @@
 
 #include <QtWebKit/qwebexecutionlistener.h>
 #include <QSharedPointer>
+#include <QDataStream>
 
 #include "runtime/browser/artemiswebpage.h"
 #include "strategies/inputgenerator/event/eventparametergenerator.h"
 #include "strategies/inputgenerator/form/forminputgenerator.h"
 #include "strategies/inputgenerator/targets/targetgenerator.h"
+#include "util/fingerprintutil.h"
 
 namespace artemis
 {
 
+// MODIFIED by CH
+// Tags of the serialized inputs, see InputSerializer
+enum InputTypes {
+    DOM_INPUT, TIMER_INPUT, AJAX_INPUT
+};
+
 class BaseInput
 {
 
@@ -44,6 +52,12 @@ public:
 
     // MODIFIED by CH
     virtual QString getSequence() const = 0;
+
+    // Identifies the input by value, two inputs with the same fingerprint have the same effect
+    virtual fingerprint_t fingerprint() const = 0;
+
+    // Writes the input type tag followed by the input, read back by InputSerializer
+    virtual void write(QDataStream& stream) const = 0;
 };
 
 }
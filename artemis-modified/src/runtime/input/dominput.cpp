@@ -94,4 +94,27 @@ QString DomInput::getSequence() const
     return mEventHandler->toString();
 }
 
+// The parameters are fingerprinted in their serialized form, so inputs equal after a round trip
+// through InputSerializer have the same fingerprint.
+fingerprint_t DomInput::fingerprint() const
+{
+    QByteArray params;
+    QDataStream stream(&params, QIODevice::WriteOnly);
+    mEvtParams->write(stream);
+
+    fingerprint_t hash = fingerprintCombine(mEventHandler->fingerprint(), mFormInput->fingerprint());
+    hash = fingerprintCombine(hash, fingerprintBytes(params));
+
+    return fingerprintCombine(hash, mTarget->fingerprint());
+}
+
+// The target is not written, InputSerializer generates it again
+void DomInput::write(QDataStream& stream) const
+{
+    stream << (quint8)DOM_INPUT;
+    mEventHandler->write(stream);
+    mFormInput->write(stream);
+    mEvtParams->write(stream);
+}
+
 }
@@ -46,6 +46,8 @@ public:
     
     // MODIFIED by CH
     QString getSequence() const;
+    fingerprint_t fingerprint() const;
+    void write(QDataStream& stream) const;
 
 private:
     const EventHandlerDescriptor* mEventHandler;
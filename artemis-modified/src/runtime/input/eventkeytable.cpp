@@ -0,0 +1,70 @@
+/*
+ * Copyright 2012 Aarhus University
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "eventkeytable.h"
+
+namespace artemis
+{
+
+EventKeyTable::EventKeyTable()
+{
+}
+
+eventkey_t EventKeyTable::intern(const QString& key)
+{
+    QHash<QString, eventkey_t>::const_iterator iter = mIds.constFind(key);
+
+    if (iter != mIds.constEnd()) {
+        return iter.value();
+    }
+
+    eventkey_t id = mNames.size();
+    mIds.insert(key, id);
+    mNames.append(key);
+
+    return id;
+}
+
+bool EventKeyTable::lookup(const QString& key, eventkey_t* id) const
+{
+    QHash<QString, eventkey_t>::const_iterator iter = mIds.constFind(key);
+
+    if (iter == mIds.constEnd()) {
+        return false;
+    }
+
+    *id = iter.value();
+    return true;
+}
+
+QString EventKeyTable::name(eventkey_t id) const
+{
+    Q_ASSERT(id < (uint)mNames.size());
+    return mNames.at(id);
+}
+
+uint EventKeyTable::size() const
+{
+    return mNames.size();
+}
+
+EventKeyTable* eventKeys()
+{
+    static EventKeyTable instance;
+    return &instance;
+}
+
+}
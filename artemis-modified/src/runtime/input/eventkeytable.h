@@ -0,0 +1,55 @@
+/*
+ * Copyright 2012 Aarhus University
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef EVENTKEYTABLE_H
+#define EVENTKEYTABLE_H
+
+#include <QHash>
+#include <QString>
+#include <QVector>
+
+namespace artemis
+{
+
+typedef uint eventkey_t;
+
+/**
+ * @brief The EventKeyTable class
+ *
+ * Interns the event keys used by the dependency analysis ("event@element", "timerinput", ...)
+ * into dense integer ids. Ids are handed out in order of first appearance, starting from 0.
+ */
+class EventKeyTable
+{
+
+public:
+    EventKeyTable();
+
+    eventkey_t intern(const QString& key);
+    bool lookup(const QString& key, eventkey_t* id) const;
+
+    QString name(eventkey_t id) const;
+    uint size() const;
+
+private:
+    QHash<QString, eventkey_t> mIds;
+    QVector<QString> mNames;
+};
+
+EventKeyTable* eventKeys();
+
+}
+
+#endif // EVENTKEYTABLE_H
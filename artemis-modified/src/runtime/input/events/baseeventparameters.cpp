@@ -53,4 +53,10 @@ EventType BaseEventParameters::type() const
     return BASE_EVENT;
 }
 
+// MODIFIED by CH
+void BaseEventParameters::write(QDataStream& stream) const
+{
+    stream << (quint8)type() << name << bubbles << cancelable;
+}
+
 }
@@ -29,6 +29,7 @@ public:
 
     QString jsString() const ;
     EventType type() const;
+    void write(QDataStream& stream) const;
 
 private:
     QString name;
@@ -63,6 +63,41 @@ DOMElementDescriptor::DOMElementDescriptor(QObject* parent, const DOMElementDesc
     this->mInvalid = other->mInvalid;
 }
 
+// MODIFIED by CH
+// Reads a descriptor written by write
+DOMElementDescriptor::DOMElementDescriptor(QObject* parent, QDataStream& stream) : QObject(parent)
+{
+    stream >> id >> tagName >> classLine >> framePath >> elementPath >> isBody >> isDocument >> isMainframe >> mInvalid;
+}
+
+// For an element found by a walk of the DOM which knows the path to it, see
+// ExecutionResultBuilder::registerFromFieldsIntoResult
+DOMElementDescriptor::DOMElementDescriptor(QObject* parent, QWebElement* elm, const QList<int>& elementPath) : QObject(parent)
+{
+    Q_CHECK_PTR(elm);
+    Q_ASSERT(!elm->isNull());
+
+    this->mInvalid = false;
+    this->id = elm->attribute("id");
+    this->tagName = elm->tagName();
+    this->classLine = QString(elm->classes().join(" "));
+    isBody = isDocument = isMainframe = false;
+
+    // the same special cases as setElementPath
+    if (tagName == "body") {
+        isBody = true;
+    } else if (tagName == "document" || tagName.toLower() == "html") {
+        isDocument = true;
+    } else {
+        this->elementPath = elementPath;
+    }
+}
+
+void DOMElementDescriptor::write(QDataStream& stream) const
+{
+    stream << id << tagName << classLine << framePath << elementPath << isBody << isDocument << isMainframe << mInvalid;
+}
+
 QWebElement DOMElementDescriptor::getElement(ArtemisWebPagePtr page) const
 {
     Q_CHECK_PTR(page);
@@ -224,6 +259,21 @@ bool DOMElementDescriptor::isInvalid() const
     return this->mInvalid;
 }
 
+// MODIFIED by CH
+// The body and the document have no element path, they are only inside a change of the whole page
+bool DOMElementDescriptor::isInside(const DomPath& region) const
+{
+    if (region.isEmpty()) {
+        return true;
+    }
+
+    if (isBody || isDocument || mInvalid || elementPath.size() < region.size()) {
+        return false;
+    }
+
+    return elementPath.mid(0, region.size()) == region;
+}
+
 uint DOMElementDescriptor::hashCode() const {
 
     uint frame_hash = 0;
@@ -251,6 +301,28 @@ uint DOMElementDescriptor::hashCode() const {
     return 29 * element_hash + 13 * frame_hash;
 }
 
+// MODIFIED by CH
+// Unlike hashCode, the fingerprint covers everything used to find the element again in getElement
+fingerprint_t DOMElementDescriptor::fingerprint() const
+{
+    fingerprint_t hash = fingerprintString(id, fingerprintString(tagName));
+
+    hash = fingerprintCombine(hash, (isDocument ? 1 : 0) | (isBody ? 2 : 0) | (isMainframe ? 4 : 0));
+    hash = fingerprintCombine(hash, framePath.size());
+
+    foreach (int fpath, framePath) {
+        hash = fingerprintCombine(hash, fpath);
+    }
+
+    hash = fingerprintCombine(hash, elementPath.size());
+
+    foreach (int element, elementPath) {
+        hash = fingerprintCombine(hash, element);
+    }
+
+    return hash;
+}
+
 QString DOMElementDescriptor::toString() const
 {
     QString elmName = "";
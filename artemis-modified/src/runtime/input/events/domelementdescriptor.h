@@ -19,8 +19,11 @@
 #include <QObject>
 #include <QtWebKit>
 #include <QDebug>
+#include <QDataStream>
 
 #include "runtime/browser/artemiswebpage.h"
+#include "runtime/browser/domstatehasher.h"
+#include "util/fingerprintutil.h"
 
 // TODO convert to new memory model
 
@@ -34,6 +37,9 @@ class DOMElementDescriptor : public QObject
 public:
     DOMElementDescriptor(QObject* parent, QWebElement* elm);
     DOMElementDescriptor(QObject* parent, const DOMElementDescriptor* other);
+    // MODIFIED by CH
+    DOMElementDescriptor(QObject* parent, QDataStream& stream);
+    DOMElementDescriptor(QObject* parent, QWebElement* elm, const QList<int>& elementPath);
 
     QWebElement getElement(ArtemisWebPagePtr page) const;
     QString getTagName();
@@ -44,6 +50,13 @@ public:
     uint hashCode() const;
     QString toString() const;
 
+    // MODIFIED by CH
+    fingerprint_t fingerprint() const;
+    void write(QDataStream& stream) const;
+
+    // true if the element is region or below it
+    bool isInside(const DomPath& region) const;
+
     QDebug friend operator<<(QDebug dbg, const DOMElementDescriptor& e);
 
 private:
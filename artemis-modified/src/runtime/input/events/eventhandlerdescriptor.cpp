@@ -30,6 +30,14 @@ EventHandlerDescriptor::EventHandlerDescriptor(QObject* parent, const EventHandl
     this->element = new DOMElementDescriptor(parent, other->element);
 }
 
+// MODIFIED by CH
+// Reads a descriptor written by write
+EventHandlerDescriptor::EventHandlerDescriptor(QObject* parent, QDataStream& stream) : QObject(parent)
+{
+    stream >> this->eventName;
+    this->element = new DOMElementDescriptor(parent, stream);
+}
+
 EventHandlerDescriptor::~EventHandlerDescriptor()
 {
 }
@@ -70,6 +78,17 @@ QString EventHandlerDescriptor::getSequence() const
     return element->toString();
 }
 
+fingerprint_t EventHandlerDescriptor::fingerprint() const
+{
+    return fingerprintCombine(fingerprintString(eventName), element->fingerprint());
+}
+
+void EventHandlerDescriptor::write(QDataStream& stream) const
+{
+    stream << eventName;
+    element->write(stream);
+}
+
 QDebug operator<<(QDebug dbg, const EventHandlerDescriptor& e)
 {
     dbg.nospace() << "(" + e.eventName << "," << e.element << ")";
@@ -32,6 +32,8 @@ class EventHandlerDescriptor : public QObject
 public:
     EventHandlerDescriptor(QObject* parent, QWebElement* elem = 0, QString name = QString());
     EventHandlerDescriptor(QObject* parent, const EventHandlerDescriptor* other);
+    // MODIFIED by CH
+    EventHandlerDescriptor(QObject* parent, QDataStream& stream);
 
     ~EventHandlerDescriptor();
 
@@ -44,6 +46,8 @@ public:
     QString toString() const;
     // MODIFIED by CH
     QString getSequence() const;
+    fingerprint_t fingerprint() const;
+    void write(QDataStream& stream) const;
 
     QDebug friend operator<<(QDebug dbg, const EventHandlerDescriptor& e);
 
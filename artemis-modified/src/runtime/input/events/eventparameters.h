@@ -17,6 +17,7 @@
 #define EVENTPARAMETERS_H
 
 #include <QObject>
+#include <QDataStream>
 
 #include "eventypes.h"
 
@@ -33,6 +34,10 @@ public:
      */
     virtual QString jsString() const = 0;
     virtual EventType type() const = 0;
+
+    // MODIFIED by CH
+    // Writes the type followed by the parameters, read back by InputSerializer
+    virtual void write(QDataStream& stream) const = 0;
 };
 
 }
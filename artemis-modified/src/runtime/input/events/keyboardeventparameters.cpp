@@ -65,6 +65,13 @@ QString KeyboardEventParameters::jsString() const
     return res;
 }
 
+// MODIFIED by CH
+void KeyboardEventParameters::write(QDataStream& stream) const
+{
+    stream << (quint8)type() << eventType << canBubble << cancelable << keyIdentifier << (quint32)keyLocation
+           << ctrlKey << altKey << shiftKey << metaKey << altGraphKey;
+}
+
 EventType KeyboardEventParameters::type() const
 {
     return KEY_EVENT;
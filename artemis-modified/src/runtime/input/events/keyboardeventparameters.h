@@ -32,6 +32,7 @@ public:
 
     QString jsString() const;
     EventType type() const;
+    void write(QDataStream& stream) const;
 
     //Event options:
     bool canBubble;
@@ -107,6 +107,13 @@ QString MouseEventParameters::jsString() const
     return res;
 }
 
+// MODIFIED by CH
+void MouseEventParameters::write(QDataStream& stream) const
+{
+    stream << (quint8)type() << typeN << canBubble << cancelable << (qint32)detail << (qint32)screenX << (qint32)screenY
+           << (qint32)clientX << (qint32)clientY << ctrlKey << altKey << shiftKey << metaKey << (qint32)button;
+}
+
 EventType MouseEventParameters::type() const
 {
     return MOUSE_EVENT;
@@ -31,6 +31,7 @@ public:
 
     QString jsString() const;
     EventType type() const;
+    void write(QDataStream& stream) const;
 
     bool canBubble;
     bool cancelable;
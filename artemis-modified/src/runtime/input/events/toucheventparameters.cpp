@@ -14,4 +14,10 @@ EventType TouchEventParameters::type() const{
     return TOUCH_EVENT;
 }
 
+// MODIFIED by CH
+void TouchEventParameters::write(QDataStream& stream) const
+{
+    stream << (quint8)type();
+}
+
 }
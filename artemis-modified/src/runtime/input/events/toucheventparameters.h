@@ -10,6 +10,7 @@ public:
 
     QString jsString() const ;
     EventType type() const;
+    void write(QDataStream& stream) const;
 
 };
 }
@@ -50,6 +50,27 @@ QSet<QString> FormField::getInputOptions() const
     return mDefaultInputs;
 }
 
+// MODIFIED by CH
+void FormField::write(QDataStream& stream) const
+{
+    stream << (qint32)mFieldType;
+    mElementDescriptor->write(stream);
+    stream << mDefaultInputs;
+}
+
+QSharedPointer<const FormField> FormField::read(QDataStream& stream)
+{
+    qint32 type;
+    stream >> type;
+
+    DOMElementDescriptor* element = new DOMElementDescriptor(NULL, stream);
+
+    QSet<QString> inputOptions;
+    stream >> inputOptions;
+
+    return QSharedPointer<const FormField>(new FormField((FormFieldTypes)type, element, inputOptions));
+}
+
 QDebug operator<<(QDebug dbg, const FormField& f)
 {
     dbg.nospace() << "{" << *f.mElementDescriptor << "," << formFieldTypeTostring(f.mFieldType) << "," << f.mDefaultInputs << "}";
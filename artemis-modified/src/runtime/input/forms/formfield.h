@@ -18,6 +18,8 @@
 
 #include <QSet>
 #include <QString>
+#include <QDataStream>
+#include <QSharedPointer>
 
 #include "formfieldtypes.h"
 #include "runtime/input/events/domelementdescriptor.h"
@@ -36,6 +38,10 @@ public:
     FormFieldTypes getType() const;
     QSet<QString> getInputOptions() const;
 
+    // MODIFIED by CH
+    void write(QDataStream& stream) const;
+    static QSharedPointer<const FormField> read(QDataStream& stream);
+
     QDebug friend operator<<(QDebug dbg, const FormField& f);
 
 private:
@@ -72,6 +72,39 @@ QString FormFieldValue::stringRepresentation() const
     return strVal;
 }
 
+// MODIFIED by CH
+void FormFieldValue::write(QDataStream& stream) const
+{
+    stream << isNoVal << isBool;
+
+    if (isBool) {
+        stream << boolVal;
+    } else if (!isNoVal) {
+        stream << strVal;
+    }
+}
+
+FormFieldValue* FormFieldValue::read(QObject* parent, QDataStream& stream)
+{
+    bool noValue;
+    bool boolean;
+    stream >> noValue >> boolean;
+
+    if (boolean) {
+        bool value;
+        stream >> value;
+        return new FormFieldValue(parent, value);
+    }
+
+    if (noValue) {
+        return new FormFieldValue(parent);
+    }
+
+    QString value;
+    stream >> value;
+    return new FormFieldValue(parent, value);
+}
+
 QDebug operator<<(QDebug dbg, const FormFieldValue& f)
 {
     if (f.isBool)
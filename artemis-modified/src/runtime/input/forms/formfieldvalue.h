@@ -18,6 +18,7 @@
 
 #include <QObject>
 #include <QString>
+#include <QDataStream>
 
 namespace artemis
 {
@@ -36,6 +37,10 @@ public:
     bool isNoValue() const;
     QString stringRepresentation() const;
 
+    // MODIFIED by CH
+    void write(QDataStream& stream) const;
+    static FormFieldValue* read(QObject* parent, QDataStream& stream);
+
     QDebug friend operator<<(QDebug dbg, const FormFieldValue& f);
 
 private:
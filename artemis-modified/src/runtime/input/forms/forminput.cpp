@@ -55,6 +55,52 @@ void FormInput::writeToPage(ArtemisWebPagePtr page) const
     }
 }
 
+// MODIFIED by CH
+// Independent of the (unspecified) iteration order of mInputs
+fingerprint_t FormInput::fingerprint() const
+{
+    fingerprint_t hash = 0;
+
+    foreach(input_t input, mInputs) {
+        fingerprint_t value = input.second->isNoValue() ? 0 : fingerprintString(input.second->stringRepresentation());
+        hash += fingerprintCombine(input.first->getDomElement()->fingerprint(), value);
+    }
+
+    return hash;
+}
+
+void FormInput::write(QDataStream& stream) const
+{
+    stream << (quint32)mInputs.size();
+
+    foreach(input_t input, mInputs) {
+        input.first->write(stream);
+        input.second->write(stream);
+    }
+}
+
+QSharedPointer<FormInput> FormInput::read(QDataStream& stream)
+{
+    quint32 size;
+    stream >> size;
+
+    QSet<QPair<QSharedPointer<const FormField>, const FormFieldValue*> > inputs;
+    QList<QSharedPointer<const FormFieldValue> > values;
+
+    for (quint32 i = 0; i < size && stream.status() == QDataStream::Ok; i++) {
+        QSharedPointer<const FormField> field = FormField::read(stream);
+        QSharedPointer<const FormFieldValue> value(FormFieldValue::read(NULL, stream));
+
+        inputs.insert(input_t(field, value.data()));
+        values.append(value);
+    }
+
+    QSharedPointer<FormInput> formInput(new FormInput(inputs));
+    formInput->mReadValues = values;
+
+    return formInput;
+}
+
 QDebug operator<<(QDebug dbg, FormInput* f)
 {
     dbg.nospace() << f->mInputs;
@@ -37,11 +37,20 @@ public:
     QSet<QPair<QSharedPointer<const FormField>, const FormFieldValue*> > getInputs() const;
     void writeToPage(ArtemisWebPagePtr) const;
 
+    // MODIFIED by CH
+    fingerprint_t fingerprint() const;
+    void write(QDataStream& stream) const;
+    static QSharedPointer<FormInput> read(QDataStream& stream);
+
     QDebug friend operator<<(QDebug dbg, FormInput* f);
 
 private:
     QSet<QPair<QSharedPointer<const FormField>, const FormFieldValue*> > mInputs;
 
+    // MODIFIED by CH
+    // the values created by read, which have no parent
+    QList<QSharedPointer<const FormFieldValue> > mReadValues;
+
 };
 
 }
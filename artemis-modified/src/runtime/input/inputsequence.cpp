@@ -19,52 +19,95 @@
 namespace artemis
 {
 
+// MODIFIED by CH
+static const fingerprint_t FINGERPRINT_BASE = Q_UINT64_C(0x100000001b3);
+
+InputSequence::Node::Node(QSharedPointer<const Node> prefix, QSharedPointer<const BaseInput> input, eventkey_t eventKey,
+                          fingerprint_t fingerprint)
+    : prefix(prefix), input(input), eventKey(eventKey), size(prefix.isNull() ? 1 : prefix->size + 1), fingerprint(fingerprint)
+{
+}
+
 InputSequence::InputSequence()
 {
 }
 
 InputSequence::InputSequence(const QList<QSharedPointer<const BaseInput> >& sequence)
-    : mSequence(sequence)
 {
+    foreach (QSharedPointer<const BaseInput> input, sequence) {
+        mLast = append(mLast, input);
+    }
+}
+
+// MODIFIED by CH
+InputSequence::InputSequence(QSharedPointer<const Node> last)
+    : mLast(last)
+{
+}
+
+QSharedPointer<const InputSequence::Node> InputSequence::append(QSharedPointer<const Node> prefix, QSharedPointer<const BaseInput> input)
+{
+    fingerprint_t fingerprint = (prefix.isNull() ? 0 : prefix->fingerprint * FINGERPRINT_BASE) + input->fingerprint();
+
+    return QSharedPointer<const Node>(new Node(prefix, input, eventKeys()->intern(input->getSequence()), fingerprint));
 }
 
 QSharedPointer<const InputSequence> InputSequence::replaceLast(QSharedPointer<const BaseInput> newLast) const
 {
-    QList<QSharedPointer<const BaseInput> > sequence = mSequence;
-    sequence.removeLast();
-    sequence.append(newLast);
+    Q_ASSERT(!mLast.isNull());
 
-    return QSharedPointer<const InputSequence>(new InputSequence(sequence));
+    return QSharedPointer<const InputSequence>(new InputSequence(append(mLast->prefix, newLast)));
 }
 
 QSharedPointer<const InputSequence> InputSequence::extend(QSharedPointer<const BaseInput> newLast) const
 {
-    QList<QSharedPointer<const BaseInput> > sequence = mSequence;
-    sequence.append(newLast);
-
-    return QSharedPointer<InputSequence>(new InputSequence(sequence));
+    return QSharedPointer<const InputSequence>(new InputSequence(append(mLast, newLast)));
 }
 
 bool InputSequence::isEmpty() const
 {
-    return mSequence.empty();
+    return mLast.isNull();
+}
+
+int InputSequence::size() const
+{
+    return mLast.isNull() ? 0 : mLast->size;
 }
 
 QSharedPointer<const BaseInput> InputSequence::getLast() const
 {
-    return mSequence.last();
+    Q_ASSERT(!mLast.isNull());
+    return mLast->input;
 }
 
-const QList<QSharedPointer<const BaseInput> > InputSequence::toList() const
+// MODIFIED by CH
+QSharedPointer<const InputSequence> InputSequence::getPrefix() const
 {
-    return mSequence;
+    Q_ASSERT(!mLast.isNull());
+    return QSharedPointer<const InputSequence>(new InputSequence(mLast->prefix));
+}
+
+InputSequence::const_iterator InputSequence::begin() const
+{
+    QVector<const Node*> path(size());
+
+    for (const Node* node = mLast.data(); node != NULL; node = node->prefix.data()) {
+        path[node->size - 1] = node;
+    }
+
+    return const_iterator(path, 0);
+}
+
+InputSequence::const_iterator InputSequence::end() const
+{
+    return const_iterator(QVector<const Node*>(), size());
 }
 
 QString InputSequence::toString() const
 {
     QString output;
 
-    foreach (QSharedPointer<const BaseInput> input, mSequence) {
+    foreach (QSharedPointer<const BaseInput> input, *this) {
         output += input->toString() + QString(" => ");
     }
 
@@ -75,12 +118,17 @@ QString InputSequence::toString() const
 QString InputSequence::getSequence() const
 {
     QString output;
-    // TODO_CH: Is there anyway I can make it to array?
-    foreach (QSharedPointer<const BaseInput> input, mSequence) {
+    foreach (QSharedPointer<const BaseInput> input, *this) {
         output += input->getSequence() + QString(",");
     }
 
     return output;
 }
 
+fingerprint_t InputSequence::getFingerprint() const
+{
+    // the raw sum does not distinguish leading inputs with fingerprint 0 from no input
+    return mLast.isNull() ? fingerprintCombine(0, 0) : fingerprintCombine(mLast->fingerprint, mLast->size);
+}
+
 }
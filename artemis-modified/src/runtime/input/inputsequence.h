@@ -17,16 +17,157 @@
 #define INPUTSEQUENCE_H
 
 #include <QList>
+#include <QVector>
 
 #include "baseinput.h"
+#include "eventkeytable.h"
 
 namespace artemis
 {
 
+/**
+ * @brief The InputSequence class
+ *
+ * Immutable, persistent list of inputs. A sequence is a pointer to its last node, and every node
+ * points to the node before it, so replaceLast and extend are O(1) and all sequences derived from
+ * the same configuration share their prefix.
+ *
+ * Length, fingerprint and the interned event key of each input are cached in the nodes.
+ *
+ * The inputs are traversed with begin/end, first to last, or with rbegin/rend, last to first.
+ * The reverse traversal does not allocate and is preferred where the order does not matter.
+ */
 class InputSequence
 {
 
+private:
+    struct Node
+    {
+        Node(QSharedPointer<const Node> prefix, QSharedPointer<const BaseInput> input, eventkey_t eventKey,
+             fingerprint_t fingerprint);
+
+        const QSharedPointer<const Node> prefix;
+        const QSharedPointer<const BaseInput> input;
+        const eventkey_t eventKey;
+        const int size;
+
+        // Sum of fingerprint(input i) * FINGERPRINT_BASE^(size-1-i), so it can be updated in O(1)
+        // when the sequence is extended or its last input replaced
+        const fingerprint_t fingerprint;
+    };
+
 public:
+    class const_reverse_iterator
+    {
+
+    public:
+        const_reverse_iterator(const Node* node = NULL) :
+            mNode(node)
+        {
+        }
+
+        inline const QSharedPointer<const BaseInput>& operator*() const
+        {
+            return mNode->input;
+        }
+
+        inline const BaseInput* operator->() const
+        {
+            return mNode->input.data();
+        }
+
+        // MODIFIED by CH
+        inline eventkey_t eventKey() const
+        {
+            return mNode->eventKey;
+        }
+
+        inline const_reverse_iterator& operator++()
+        {
+            mNode = mNode->prefix.data();
+            return *this;
+        }
+
+        inline const_reverse_iterator operator++(int)
+        {
+            const_reverse_iterator old = *this;
+            mNode = mNode->prefix.data();
+            return old;
+        }
+
+        inline bool operator==(const const_reverse_iterator& other) const
+        {
+            return mNode == other.mNode;
+        }
+
+        inline bool operator!=(const const_reverse_iterator& other) const
+        {
+            return mNode != other.mNode;
+        }
+
+    private:
+        const Node* mNode;
+    };
+
+    class const_iterator
+    {
+
+    public:
+        const_iterator() :
+            mIndex(0)
+        {
+        }
+
+        const_iterator(const QVector<const Node*>& path, int index) :
+            mPath(path),
+            mIndex(index)
+        {
+        }
+
+        inline const QSharedPointer<const BaseInput>& operator*() const
+        {
+            return mPath.at(mIndex)->input;
+        }
+
+        inline const BaseInput* operator->() const
+        {
+            return mPath.at(mIndex)->input.data();
+        }
+
+        inline eventkey_t eventKey() const
+        {
+            return mPath.at(mIndex)->eventKey;
+        }
+
+        inline const_iterator& operator++()
+        {
+            mIndex++;
+            return *this;
+        }
+
+        inline const_iterator operator++(int)
+        {
+            const_iterator old = *this;
+            mIndex++;
+            return old;
+        }
+
+        inline bool operator==(const const_iterator& other) const
+        {
+            return mIndex == other.mIndex;
+        }
+
+        inline bool operator!=(const const_iterator& other) const
+        {
+            return mIndex != other.mIndex;
+        }
+
+    private:
+        // the nodes of the sequence, first to last; implicitly shared between copies
+        QVector<const Node*> mPath;
+        int mIndex;
+    };
+
     InputSequence();
     InputSequence(const QList<QSharedPointer<const BaseInput> >& sequence);
 
@@ -34,16 +175,41 @@ public:
     QSharedPointer<const InputSequence> extend(QSharedPointer<const BaseInput> newLast) const;
 
     bool isEmpty() const;
+    int size() const;
     QSharedPointer<const BaseInput> getLast() const;
-    const QList<QSharedPointer<const BaseInput> > toList() const;
+
+    // MODIFIED by CH
+    // The sequence without its last input, sharing all nodes with this sequence
+    QSharedPointer<const InputSequence> getPrefix() const;
+
+    const_iterator begin() const;
+    const_iterator end() const;
+
+    inline const_reverse_iterator rbegin() const
+    {
+        return const_reverse_iterator(mLast.data());
+    }
+
+    inline const_reverse_iterator rend() const
+    {
+        return const_reverse_iterator();
+    }
 
     QString toString() const;
 
     // MODIFIED by CH
     QString getSequence() const;
 
+    // Identifies the sequence by the fingerprints of its inputs, in order
+    fingerprint_t getFingerprint() const;
+
 private:
-    const QList<QSharedPointer<const BaseInput> > mSequence;
+    InputSequence(QSharedPointer<const Node> last);
+
+    static QSharedPointer<const Node> append(QSharedPointer<const Node> prefix, QSharedPointer<const BaseInput> input);
+
+    // NULL for the empty sequence
+    QSharedPointer<const Node> mLast;
 };
 
 typedef QSharedPointer<InputSequence> InputSequencePtr;
@@ -0,0 +1,183 @@
+/*
+ * Copyright 2012 Aarhus University
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <QDebug>
+
+#include "runtime/browser/timer.h"
+#include "runtime/input/events/baseeventparameters.h"
+#include "runtime/input/events/keyboardeventparameters.h"
+#include "runtime/input/events/mouseeventparameters.h"
+#include "runtime/input/events/toucheventparameters.h"
+
+#include "ajaxinput.h"
+#include "dominput.h"
+#include "timerinput.h"
+
+#include "inputserializer.h"
+
+namespace artemis
+{
+
+InputSerializer::InputSerializer(TargetGenerator* targetGenerator) :
+    mTargetGenerator(targetGenerator)
+{
+}
+
+void InputSerializer::write(QDataStream& stream, ExecutableConfigurationConstPtr configuration) const
+{
+    InputSequenceConstPtr sequence = configuration->getInputSequence();
+
+    stream << configuration->getUrl() << (quint32)sequence->size();
+
+    foreach (QSharedPointer<const BaseInput> input, *sequence) {
+        write(stream, input);
+    }
+}
+
+/**
+ * Returns a null pointer if the stream is corrupt.
+ */
+ExecutableConfigurationConstPtr InputSerializer::readConfiguration(QDataStream& stream) const
+{
+    QUrl url;
+    quint32 size;
+    stream >> url >> size;
+
+    QList<QSharedPointer<const BaseInput> > inputs;
+
+    for (quint32 i = 0; i < size; i++) {
+        QSharedPointer<const BaseInput> input = readInput(stream);
+
+        if (input.isNull()) {
+            return ExecutableConfigurationConstPtr();
+        }
+
+        inputs.append(input);
+    }
+
+    if (stream.status() != QDataStream::Ok) {
+        return ExecutableConfigurationConstPtr();
+    }
+
+    return ExecutableConfigurationConstPtr(new ExecutableConfiguration(InputSequenceConstPtr(new InputSequence(inputs)), url));
+}
+
+void InputSerializer::write(QDataStream& stream, QSharedPointer<const BaseInput> input) const
+{
+    input->write(stream);
+}
+
+QSharedPointer<const BaseInput> InputSerializer::readInput(QDataStream& stream) const
+{
+    quint8 type;
+    stream >> type;
+
+    if (stream.status() != QDataStream::Ok) {
+        return QSharedPointer<const BaseInput>();
+    }
+
+    switch (type) {
+    case DOM_INPUT: {
+        EventHandlerDescriptor* handler = new EventHandlerDescriptor(NULL, stream);
+        QSharedPointer<FormInput> formInput = FormInput::read(stream);
+        EventParameters* params = readEventParameters(stream);
+
+        if (params == NULL) {
+            delete handler;
+            return QSharedPointer<const BaseInput>();
+        }
+
+        TargetDescriptor* target = mTargetGenerator->generateTarget(NULL, handler);
+
+        return QSharedPointer<const BaseInput>(new DomInput(handler, formInput, params, target));
+    }
+
+    case TIMER_INPUT: {
+        qint32 id;
+        qint32 timeout;
+        bool singleShot;
+        stream >> id >> timeout >> singleShot;
+
+        return QSharedPointer<const BaseInput>(new TimerInput(QSharedPointer<const Timer>(new Timer(id, timeout, singleShot))));
+    }
+
+    case AJAX_INPUT: {
+        qint32 callbackId;
+        stream >> callbackId;
+
+        return QSharedPointer<const BaseInput>(new AjaxInput(callbackId));
+    }
+
+    default:
+        qWarning() << "InputSerializer: unknown input type" << type;
+        return QSharedPointer<const BaseInput>();
+    }
+}
+
+/**
+ * Reads the parameters written by EventParameters::write, returns NULL if the stream is corrupt.
+ */
+EventParameters* InputSerializer::readEventParameters(QDataStream& stream) const
+{
+    quint8 type;
+    stream >> type;
+
+    if (stream.status() != QDataStream::Ok) {
+        return NULL;
+    }
+
+    switch (type) {
+    case BASE_EVENT: {
+        QString name;
+        bool bubbles;
+        bool cancelable;
+        stream >> name >> bubbles >> cancelable;
+
+        return new BaseEventParameters(NULL, name, bubbles, cancelable);
+    }
+
+    case MOUSE_EVENT: {
+        QString name;
+        bool canBubble, cancelable, ctrlKey, altKey, shiftKey, metaKey;
+        qint32 detail, screenX, screenY, clientX, clientY, button;
+        stream >> name >> canBubble >> cancelable >> detail >> screenX >> screenY >> clientX >> clientY
+               >> ctrlKey >> altKey >> shiftKey >> metaKey >> button;
+
+        return new MouseEventParameters(NULL, name, canBubble, cancelable, detail, screenX, screenY, clientX, clientY,
+                                        ctrlKey, altKey, shiftKey, metaKey, button);
+    }
+
+    case KEY_EVENT: {
+        QString name, keyIdentifier;
+        bool canBubble, cancelable, ctrlKey, altKey, shiftKey, metaKey, altGraphKey;
+        quint32 keyLocation;
+        stream >> name >> canBubble >> cancelable >> keyIdentifier >> keyLocation
+               >> ctrlKey >> altKey >> shiftKey >> metaKey >> altGraphKey;
+
+        return new KeyboardEventParameters(NULL, name, canBubble, cancelable, keyIdentifier, keyLocation,
+                                           ctrlKey, altKey, shiftKey, metaKey, altGraphKey);
+    }
+
+    case TOUCH_EVENT:
+        return new TouchEventParameters();
+
+    default:
+        qWarning() << "InputSerializer: unknown event parameter type" << type;
+        return NULL;
+    }
+}
+
+}
@@ -0,0 +1,62 @@
+/*
+ * Copyright 2012 Aarhus University
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef INPUTSERIALIZER_H
+#define INPUTSERIALIZER_H
+
+#include <QDataStream>
+#include <QSharedPointer>
+
+#include "runtime/executableconfiguration.h"
+#include "runtime/input/events/eventparameters.h"
+#include "strategies/inputgenerator/targets/targetgenerator.h"
+
+#include "baseinput.h"
+
+namespace artemis
+{
+
+/**
+ * @brief The InputSerializer class
+ *
+ * Writes configurations and inputs to a QDataStream and reads them back.
+ *
+ * Targets of dom inputs are not written. They only depend on the event handler (see TargetGenerator),
+ * so they are generated again when read. The element a target picks is seeded per input when it is
+ * applied (see WebKitExecutor::executeInputs), so the replayed input dispatches to the same element.
+ */
+class InputSerializer
+{
+
+public:
+    InputSerializer(TargetGenerator* targetGenerator);
+
+    void write(QDataStream& stream, ExecutableConfigurationConstPtr configuration) const;
+    ExecutableConfigurationConstPtr readConfiguration(QDataStream& stream) const;
+
+    void write(QDataStream& stream, QSharedPointer<const BaseInput> input) const;
+    QSharedPointer<const BaseInput> readInput(QDataStream& stream) const;
+
+private:
+    EventParameters* readEventParameters(QDataStream& stream) const;
+
+    TargetGenerator* mTargetGenerator;
+};
+
+typedef QSharedPointer<InputSerializer> InputSerializerPtr;
+
+}
+
+#endif // INPUTSERIALIZER_H
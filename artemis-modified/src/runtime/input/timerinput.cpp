@@ -60,4 +60,14 @@ QString TimerInput::getSequence() const
     return QString("timerinput");
 }
 
+fingerprint_t TimerInput::fingerprint() const
+{
+    return fingerprintCombine(31, mTimer->getId());
+}
+
+void TimerInput::write(QDataStream& stream) const
+{
+    stream << (quint8)TIMER_INPUT << (qint32)mTimer->getId() << (qint32)mTimer->getTimeout() << mTimer->isSingleShot();
+}
+
 }
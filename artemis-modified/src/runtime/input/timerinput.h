@@ -39,6 +39,8 @@ public:
 
     // MODIFIED by CH
     QString getSequence() const;
+    fingerprint_t fingerprint() const;
+    void write(QDataStream& stream) const;
 
 private:
     QSharedPointer<const Timer> mTimer;
@@ -19,9 +19,13 @@
 #include <QObject>
 #include <QUrl>
 #include <QSettings>
+#include <QStringList>
 
 #include "runtime/worklist/worklist.h"
+#include "runtime/browser/analysisprofile.h"
+#include "runtime/browser/domstatehasher.h"
 #include "strategies/termination/terminationstrategy.h"
+#include "strategies/termination/compositetermination.h"
 #include "strategies/prioritizer/prioritizerstrategy.h"
 #include "strategies/inputgenerator/targets/targetdescriptor.h"
 #include "runtime/input/events/eventhandlerdescriptor.h"
@@ -42,6 +46,11 @@ enum CoverageReport {
     STDOUT, HTML, NONE
 };
 
+// MODIFIED by CH
+enum DuplicateFilters {
+    DUPLICATES_KEEP, DUPLICATES_EXACT, DUPLICATES_BLOOM
+};
+
 typedef struct OptionsType {
 
     OptionsType() :
@@ -51,7 +60,23 @@ typedef struct OptionsType {
         disableStateCheck(true),
         formInputGenerationStrategy(Random),
         prioritizerStrategy(CONSTANT),
-        outputCoverage(NONE)
+        outputCoverage(NONE),
+        dependencyFile("dep.txt"),
+        condenseDependencies(false),
+        duplicateFilter(DUPLICATES_KEEP),
+        worklistMemoryLimit(0),
+        forkAfterLoad(false),
+        forkCheckpoints(0),
+        workers(0),
+        analysisProfile(PROFILE_FULL),
+        pipelineExecution(false),
+        timeBudget(0),
+        plateauIterations(0),
+        plateauSeconds(0),
+        terminationMode(TERMINATE_ANY),
+        eventTimeout(0),
+        sequenceTimeout(0),
+        domDiff(false)
     {}
 
     QMap<QString, QString> presetFormfields;
@@ -75,6 +100,30 @@ typedef struct OptionsType {
     PrioritizerStrategies prioritizerStrategy;
     CoverageReport outputCoverage;
 
+    // MODIFIED by CH
+    QString dependencyFile;
+    bool condenseDependencies;
+    DuplicateFilters duplicateFilter;
+    int worklistMemoryLimit;
+    bool forkAfterLoad;
+    int forkCheckpoints;
+    int workers;
+    QString workerServer;
+    QStringList resourceCacheInclude;
+    QStringList resourceCacheExclude;
+    AnalysisProfiles analysisProfile;
+    bool pipelineExecution;
+    int timeBudget;
+    int plateauIterations;
+    int plateauSeconds;
+    CompositeTerminationModes terminationMode;
+    int eventTimeout;
+    int sequenceTimeout;
+    QString recordRunLog;
+    QString replayRunLog;
+    bool domDiff;
+    DomStateAbstraction stateAbstraction;
+
 } Options;
 
 }
@@ -0,0 +1,189 @@
+/*
+ * Copyright 2012 Aarhus University
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstring>
+
+#include <QDebug>
+
+#include "runlog.h"
+
+namespace artemis
+{
+
+static const char RUNLOG_MAGIC[] = "ARUN";
+static const quint32 RUNLOG_VERSION = 2;
+
+enum RunLogRecords {
+    RUNLOG_EXECUTION = 1, RUNLOG_END = 2
+};
+
+RunLogEntry::RunLogEntry() :
+    stateHash(0),
+    numEventHandlers(0),
+    numFormFields(0),
+    numTimers(0),
+    numAjaxCallbacks(0),
+    coveredLines(0),
+    timedOut(false)
+{
+}
+
+RunLogEntry::RunLogEntry(ExecutableConfigurationConstPtr configuration, QSharedPointer<ExecutionResult> result,
+                         uint coveredLines) :
+    configuration(configuration),
+    stateHash(result->getPageStateHash()),
+    numEventHandlers(result->getEventHandlers().size()),
+    numFormFields(result->getFormFields().size()),
+    numTimers(result->getTimers().size()),
+    numAjaxCallbacks(result->getAjaxCallbackHandlers().size()),
+    coveredLines(coveredLines),
+    timedOut(result->isTimedOut())
+{
+}
+
+/**
+ * Compares the summaries, not the configurations
+ */
+bool RunLogEntry::matches(const RunLogEntry& other) const
+{
+    return stateHash == other.stateHash &&
+            numEventHandlers == other.numEventHandlers &&
+            numFormFields == other.numFormFields &&
+            numTimers == other.numTimers &&
+            numAjaxCallbacks == other.numAjaxCallbacks &&
+            coveredLines == other.coveredLines &&
+            timedOut == other.timedOut;
+}
+
+QString RunLogEntry::toString() const
+{
+    return QString("state %1, %2 handlers, %3 fields, %4 timers, %5 ajax callbacks, %6 lines covered%7")
+            .arg(stateHash).arg(numEventHandlers).arg(numFormFields).arg(numTimers).arg(numAjaxCallbacks)
+            .arg(coveredLines).arg(timedOut ? ", timed out" : "");
+}
+
+RunLog::RunLog(InputSerializerPtr serializer) :
+    mSerializer(serializer)
+{
+}
+
+RunLog::~RunLog()
+{
+    mFile.close();
+}
+
+bool RunLog::create(const QString& path)
+{
+    mFile.setFileName(path);
+
+    if (!mFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        return false;
+    }
+
+    mStream.setDevice(&mFile);
+    mStream.setVersion(QDataStream::Qt_4_8);
+
+    mStream.writeRawData(RUNLOG_MAGIC, 4);
+    mStream << RUNLOG_VERSION;
+
+    return mStream.status() == QDataStream::Ok;
+}
+
+void RunLog::record(const RunLogEntry& entry)
+{
+    if (!mFile.isOpen()) {
+        return;
+    }
+
+    mStream << (quint8)RUNLOG_EXECUTION;
+    mSerializer->write(mStream, entry.configuration);
+
+    mStream << entry.stateHash << entry.numEventHandlers << entry.numFormFields << entry.numTimers
+            << entry.numAjaxCallbacks << entry.coveredLines << entry.timedOut;
+}
+
+void RunLog::finish(uint coveredLines)
+{
+    if (!mFile.isOpen()) {
+        return;
+    }
+
+    mStream << (quint8)RUNLOG_END << (quint32)coveredLines;
+    mFile.close();
+}
+
+bool RunLog::load(const QString& path, QList<RunLogEntry>* entries, uint* coveredLines) const
+{
+    QFile file(path);
+
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_4_8);
+
+    char magic[4];
+    quint32 version = 0;
+
+    if (stream.readRawData(magic, 4) != 4 || memcmp(magic, RUNLOG_MAGIC, 4) != 0) {
+        return false;
+    }
+
+    stream >> version;
+
+    if (version != RUNLOG_VERSION) {
+        qWarning() << "WARN: Unsupported run log version" << version;
+        return false;
+    }
+
+    while (stream.status() == QDataStream::Ok) {
+        quint8 type;
+        stream >> type;
+
+        if (stream.status() != QDataStream::Ok) {
+            break;
+        }
+
+        if (type == RUNLOG_END) {
+            quint32 lines;
+            stream >> lines;
+            *coveredLines = lines;
+
+            return stream.status() == QDataStream::Ok;
+        }
+
+        if (type != RUNLOG_EXECUTION) {
+            break;
+        }
+
+        RunLogEntry entry;
+        entry.configuration = mSerializer->readConfiguration(stream);
+
+        if (entry.configuration.isNull()) {
+            break;
+        }
+
+        stream >> entry.stateHash >> entry.numEventHandlers >> entry.numFormFields >> entry.numTimers
+               >> entry.numAjaxCallbacks >> entry.coveredLines >> entry.timedOut;
+
+        entries->append(entry);
+    }
+
+    return false;
+}
+
+}
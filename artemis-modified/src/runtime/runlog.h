@@ -0,0 +1,93 @@
+/*
+ * Copyright 2012 Aarhus University
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef RUNLOG_H
+#define RUNLOG_H
+
+#include <QDataStream>
+#include <QFile>
+#include <QList>
+#include <QSharedPointer>
+#include <QString>
+
+#include "runtime/executableconfiguration.h"
+#include "runtime/browser/executionresult.h"
+#include "runtime/input/inputserializer.h"
+
+namespace artemis
+{
+
+/**
+ * What is compared when a run is replayed, the configuration plus a summary of its result
+ */
+struct RunLogEntry
+{
+    RunLogEntry();
+    RunLogEntry(ExecutableConfigurationConstPtr configuration, QSharedPointer<ExecutionResult> result,
+                uint coveredLines);
+
+    bool matches(const RunLogEntry& other) const;
+    QString toString() const;
+
+    ExecutableConfigurationConstPtr configuration;
+
+    qint64 stateHash;
+    quint32 numEventHandlers;
+    quint32 numFormFields;
+    quint32 numTimers;
+    quint32 numAjaxCallbacks;
+    quint32 coveredLines; // covered by the whole run after this execution
+    bool timedOut;
+};
+
+/**
+ * @brief The RunLog class
+ *
+ * Binary log of the configurations executed by a run, in the order their results were handled,
+ * see --record and --replay.
+ *
+ *   header   "ARUN", version
+ *   records  RUNLOG_EXECUTION, configuration (see InputSerializer), summary (see RunLogEntry)
+ *   end      RUNLOG_END, lines covered by the run
+ *
+ * Form values are part of the configuration, so a replay does not depend on the random input
+ * generation of the recorded run.
+ */
+class RunLog
+{
+
+public:
+    RunLog(InputSerializerPtr serializer);
+    ~RunLog();
+
+    bool create(const QString& path);
+    void record(const RunLogEntry& entry);
+    void finish(uint coveredLines);
+
+    // reads a complete log, false if the file is missing, corrupt or truncated
+    bool load(const QString& path, QList<RunLogEntry>* entries, uint* coveredLines) const;
+
+private:
+    InputSerializerPtr mSerializer;
+
+    QFile mFile;
+    QDataStream mStream;
+};
+
+typedef QSharedPointer<RunLog> RunLogPtr;
+
+}
+
+#endif // RUNLOG_H
@@ -22,6 +22,7 @@
 #include <QSharedPointer>
 
 #include "worklist/deterministicworklist.h"
+#include "worklist/replayworklist.h"
 #include "model/coverage/coveragetooutputstream.h"
 #include "util/loggingutil.h"
 
@@ -32,6 +33,9 @@
 #include "strategies/inputgenerator/form/staticforminputgenerator.h"
 #include "strategies/inputgenerator/form/constantstringforminputgenerator.h"
 #include "strategies/termination/numberofiterationstermination.h"
+#include "strategies/termination/timebudgettermination.h"
+#include "strategies/termination/coverageplateautermination.h"
+#include "strategies/termination/compositetermination.h"
 
 #include "strategies/prioritizer/constantprioritizer.h"
 #include "strategies/prioritizer/randomprioritizer.h"
@@ -85,6 +89,12 @@ Runtime::Runtime(QObject* parent, const Options& options, QUrl url) : QObject(pa
         options.presetCookies, url.host());
     ajaxRequestListner->setCookieJar(immutableCookieJar);
 
+    // MODIFIED by CH
+    if (!options.resourceCacheInclude.isEmpty()) {
+        ajaxRequestListner->setResourceCache(ResourceCachePtr(new ResourceCache(options.resourceCacheInclude,
+                                                                                options.resourceCacheExclude)));
+    }
+
     /** JQuery support **/
 
     JQueryListener* jqueryListener = new JQueryListener(this);
@@ -93,7 +103,17 @@ Runtime::Runtime(QObject* parent, const Options& options, QUrl url) : QObject(pa
 
     mAppmodel = AppModelPtr(new AppModel(options.coverageIgnoreUrls));
 
-    mWebkitExecutor = new WebKitExecutor(this, mAppmodel, options.presetFormfields, jqueryListener, ajaxRequestListner);
+    mWebkitExecutor = new WebKitExecutor(this, mAppmodel, options.presetFormfields, jqueryListener, ajaxRequestListner,
+                                         options.forkAfterLoad);
+    mWebkitExecutor->setAnalysisProfile(options.analysisProfile);
+    mWebkitExecutor->setTimeouts(options.eventTimeout, options.sequenceTimeout);
+    mWebkitExecutor->setKeepPageContents(!options.dumpPageStates.isNull());
+    mWebkitExecutor->setDomDiff(options.domDiff);
+
+    // only used by the state check
+    if (!options.disableStateCheck) {
+        mWebkitExecutor->setStateAbstraction(options.stateAbstraction);
+    }
 
     QSharedPointer<FormInputGenerator> formInputGenerator;
     switch (options.formInputGenerationStrategy) {
@@ -109,12 +129,34 @@ Runtime::Runtime(QObject* parent, const Options& options, QUrl url) : QObject(pa
         assert(false);
     }
 
+    QSharedPointer<StaticEventParameterGenerator> eventParameterGenerator(new StaticEventParameterGenerator());
+    TargetGenerator* targetGenerator = new TargetGenerator(this, jqueryListener);
+
     mInputgenerator = new RandomInputGenerator(this,
                                                formInputGenerator,
-                                               QSharedPointer<StaticEventParameterGenerator>(new StaticEventParameterGenerator()),
-                                               new TargetGenerator(this, jqueryListener),
+                                               eventParameterGenerator,
+                                               targetGenerator,
                                                options.numberSameLength);
-    mTerminationStrategy = new NumberOfIterationsTermination(this, options.iterationLimit);
+    // MODIFIED by CH
+    // a replay executes the whole log, without any termination strategy
+    mReplaying = !options.replayRunLog.isEmpty();
+
+    CompositeTermination* termination = new CompositeTermination(this, options.terminationMode);
+
+    if (options.iterationLimit > 0 && !mReplaying) {
+        termination->addStrategy(new NumberOfIterationsTermination(NULL, options.iterationLimit));
+    }
+
+    if (options.timeBudget > 0 && !mReplaying) {
+        termination->addStrategy(new TimeBudgetTermination(NULL, options.timeBudget));
+    }
+
+    if ((options.plateauIterations > 0 || options.plateauSeconds > 0) && !mReplaying) {
+        termination->addStrategy(new CoveragePlateauTermination(NULL, mAppmodel, options.plateauIterations,
+                                                                options.plateauSeconds));
+    }
+
+    mTerminationStrategy = termination;
 
     switch (options.prioritizerStrategy) {
     case CONSTANT:
@@ -140,11 +182,68 @@ Runtime::Runtime(QObject* parent, const Options& options, QUrl url) : QObject(pa
         assert(false);
     }
 
-    mWorklist = WorkListPtr(new DeterministicWorkList(mPrioritizerStrategy));
+    // MODIFIED by CH
+    InputSerializerPtr serializer = InputSerializerPtr(new InputSerializer(targetGenerator));
+    DeterministicWorkList* worklist = new DeterministicWorkList(mPrioritizerStrategy, options.condenseDependencies, options.duplicateFilter);
+
+    if (options.worklistMemoryLimit > 0) {
+        worklist->enableSpilling(options.worklistMemoryLimit, serializer);
+    }
+
+    if (options.forkCheckpoints > 0) {
+        mWebkitExecutor->enableCheckpoints(options.forkCheckpoints, serializer);
+    }
+
+    mWorklist = WorkListPtr(worklist);
+
+    mReplayCoveredLines = 0;
+    mReplayMismatches = 0;
+
+    if (mReplaying) {
+        QList<RunLogEntry> entries;
+
+        if (!RunLog(serializer).load(options.replayRunLog, &entries, &mReplayCoveredLines)) {
+            Log::fatal("Could not read the run log " + options.replayRunLog.toStdString());
+            exit(1);
+        }
+
+        QList<ExecutableConfigurationConstPtr> configurations;
+
+        foreach (RunLogEntry entry, entries) {
+            configurations.append(entry.configuration);
+            mReplayEntries.insert(entry.configuration.data(), entry);
+        }
+
+        mWorklist = WorkListPtr(new ReplayWorkList(configurations));
+    }
+
+    if (!options.recordRunLog.isEmpty()) {
+        mRunLog = RunLogPtr(new RunLog(serializer));
 
-    QObject::connect(mWebkitExecutor, SIGNAL(sigExecutedSequence(ExecutableConfigurationConstPtr, QSharedPointer<ExecutionResult>)),
+        if (!mRunLog->create(options.recordRunLog)) {
+            Log::fatal("Could not create the run log " + options.recordRunLog.toStdString());
+            exit(1);
+        }
+    }
+
+    mExecutorPool = NULL;
+    mTerminating = false;
+
+    if (options.workers > 0) {
+        mExecutorPool = new ExecutorPool(this, mAppmodel, jqueryListener, serializer, options.workers);
+
+        if (!mExecutorPool->start()) {
+            qWarning() << "WARN: No worker could be started, executing in this process";
+            delete mExecutorPool;
+            mExecutorPool = NULL;
+        }
+    }
+
+    QObject* executor = mExecutorPool != NULL ? (QObject*)mExecutorPool : (QObject*)mWebkitExecutor;
+
+    QObject::connect(executor, SIGNAL(sigExecutedSequence(ExecutableConfigurationConstPtr, QSharedPointer<ExecutionResult>)),
                      this, SLOT(postConcreteExecution(ExecutableConfigurationConstPtr, QSharedPointer<ExecutionResult>)));
-    QObject::connect(mWebkitExecutor, SIGNAL(sigAbortedExecution(QString)),
+    QObject::connect(executor, SIGNAL(sigAbortedExecution(QString)),
                      this, SLOT(slAbortedExecution(QString)));
 
 
@@ -170,8 +269,8 @@ void Runtime::startAnalysis(QUrl url)
     struct timeval curT1;
     struct timeval curT2;
     gettimeofday(&curT1, NULL);
-    if (testType == 1) {
-        mWorklist->readFile(url);
+    if (testType != 0 && !mReplaying) {
+        mWorklist->readFile(mOptions.dependencyFile);
     } else {
         cout << "Don't have to read!\n";
     }
@@ -185,6 +284,13 @@ void Runtime::startAnalysis(QUrl url)
     totaltime1 = 0;
     totaltime2 = 0;
 
+    // MODIFIED by CH
+    // only network replies are fetched off the GUI thread, local pages leave nothing to overlap
+    if (mOptions.pipelineExecution && url.scheme() != "http" && url.scheme() != "https") {
+        qWarning() << "WARN: --pipeline only overlaps http(s) page loads, ignoring it for" << url.toString();
+        mOptions.pipelineExecution = false;
+    }
+
     mWorklist->add(initialConfiguration, mAppmodel, dependencyString);
 
     preConcreteExecution();
@@ -208,47 +314,88 @@ void Runtime::preConcreteExecution()
         return;
     } 
     */
-    if (mWorklist->empty() ||
-        mTerminationStrategy->shouldTerminate()) {
+    // MODIFIED by CH
+    // the new configurations of a deferred result may be the only ones left
+    if (mWorklist->empty()) {
+        handleDeferredResult();
+    }
+
+    // with an executor pool the analysis only ends once the running executions are done, as
+    // their results may add configurations or coverage
+    if (!mTerminating && !mWorklist->empty() && mTerminationStrategy->shouldTerminate()) {
+        mTerminating = true;
+    }
+
+    if (mTerminating || mWorklist->empty()) {
+
+        if (mExecutorPool != NULL && mExecutorPool->numBusy() > 0) {
+            return;
+        }
+
+        if (mExecutorPool != NULL) {
+            mExecutorPool->detach();
+        }
 
         mWebkitExecutor->detach();
         finishAnalysis();
         return;
     }
-    // MODIFIED by CH
-    //cout << "\n============= New-Iteration =============\n";
-    //cout << "--------------- WORKLIST ----------------\n";
-    ///cout << mWorklist->toString().toStdString();
-    linesCovered =mAppmodel->getCoverageListener()->getNumCoveredLines();
-    cout << "#Iteration: " << iterationCnt << ", " << ms/1000.0 << ", " 
-     << linesCovered  << '\n';
-    cout << "#Iteration2: " << iterationCnt << ", " << totalTry << ", " 
-     << blockedCnt << ", " << blockedCnt2  << '\n';
-    cout << "#TimeTakes: " << iterationCnt << ", " << ms/1000.0 << ", "
-     << totaltime1/1000.0 << ", " << totaltime2/1000.0 << "\n";
-    iterationCnt++;
-    if (iterationCnt%100 == 0) {
-        cout << "========================Worklist=========================================\n";
-        cout << "Iteration: " << iterationCnt << ", Size: " << mWorklist->size() << "\n";
-        cout << mWorklist->toString().toStdString() << "\n";
-        cout << "=========================================================================\n";
-    }
-    /*
-    if (iterationCnt == 500) {
-        cout << "--------------- WORKLIST ----------------\n" ;
-        cout << mWorklist->toString().toStdString();
-    }
-    */
-    /*
-    Log::debug("\n============= New-Iteration =============");
-    Log::debug("--------------- WORKLIST ----------------\n");
-    Log::debug(mWorklist->toString().toStdString());
-    Log::debug("--------------- COVERAGE ----------------\n");
-    Log::debug(mAppmodel->getCoverageListener()->toString().toStdString());
-    */
-    ExecutableConfigurationConstPtr nextConfiguration = mWorklist->remove();
 
-    mWebkitExecutor->executeSequence(nextConfiguration); // calls the slExecutedSequence method as callback
+    // every idle worker of the pool gets a configuration, one at a time otherwise
+    while (true) {
+        // MODIFIED by CH
+        //cout << "\n============= New-Iteration =============\n";
+        //cout << "--------------- WORKLIST ----------------\n";
+        ///cout << mWorklist->toString().toStdString();
+        linesCovered =mAppmodel->getCoverageListener()->getNumCoveredLines();
+        cout << "#Iteration: " << iterationCnt << ", " << ms/1000.0 << ", " 
+         << linesCovered  << '\n';
+        cout << "#Iteration2: " << iterationCnt << ", " << totalTry << ", " 
+         << blockedCnt << ", " << blockedCnt2  << '\n';
+        cout << "#TimeTakes: " << iterationCnt << ", " << ms/1000.0 << ", "
+         << totaltime1/1000.0 << ", " << totaltime2/1000.0 << "\n";
+        iterationCnt++;
+        if (iterationCnt%100 == 0) {
+            cout << "========================Worklist=========================================\n";
+            cout << "Iteration: " << iterationCnt << ", Size: " << mWorklist->size() << "\n";
+            cout << mWorklist->toString().toStdString() << "\n";
+            cout << "=========================================================================\n";
+        }
+        /*
+        if (iterationCnt == 500) {
+            cout << "--------------- WORKLIST ----------------\n" ;
+            cout << mWorklist->toString().toStdString();
+        }
+        */
+        /*
+        Log::debug("\n============= New-Iteration =============");
+        Log::debug("--------------- WORKLIST ----------------\n");
+        Log::debug(mWorklist->toString().toStdString());
+        Log::debug("--------------- COVERAGE ----------------\n");
+        Log::debug(mAppmodel->getCoverageListener()->toString().toStdString());
+        */
+        ExecutableConfigurationConstPtr nextConfiguration = mWorklist->remove();
+
+        if (mExecutorPool == NULL) {
+            mWebkitExecutor->executeSequence(nextConfiguration); // calls the slExecutedSequence method as callback
+
+            // done while an http(s) page is fetched on Qt's network thread, until the event loop
+            // runs again
+            handleDeferredResult();
+            return;
+        }
+
+        mExecutorPool->executeSequence(nextConfiguration);
+
+        if (mExecutorPool->numIdle() == 0 || mWorklist->empty()) {
+            return;
+        }
+
+        if (mTerminationStrategy->shouldTerminate()) {
+            mTerminating = true;
+            return;
+        }
+    }
 }
 
 /**
@@ -258,11 +405,62 @@ void Runtime::preConcreteExecution()
  */
 void Runtime::postConcreteExecution(ExecutableConfigurationConstPtr configuration, QSharedPointer<ExecutionResult> result)
 {
+    // MODIFIED by CH
+    if (mOptions.pipelineExecution && mExecutorPool == NULL) {
+        // normally done already, unless the page was loaded before executeSequence returned
+        handleDeferredResult();
+
+        mDeferredConfiguration = configuration;
+        mDeferredResult = result;
+    } else {
+        handleExecutionResult(configuration, result);
+    }
+
+    preConcreteExecution();
+}
+
+// MODIFIED by CH
+void Runtime::handleDeferredResult()
+{
+    if (mDeferredConfiguration.isNull()) {
+        return;
+    }
+
+    ExecutableConfigurationConstPtr configuration = mDeferredConfiguration;
+    QSharedPointer<ExecutionResult> result = mDeferredResult;
+
+    mDeferredConfiguration.clear();
+    mDeferredResult.clear();
+
+    handleExecutionResult(configuration, result);
+}
+
+/**
+ * Generates the configurations following configuration, unless its page state was seen before or
+ * its execution timed out (extending it would only time out again)
+ */
+void Runtime::handleExecutionResult(ExecutableConfigurationConstPtr configuration, QSharedPointer<ExecutionResult> result)
+{
+    if (!mRunLog.isNull()) {
+        mRunLog->record(RunLogEntry(configuration, result, mAppmodel->getCoverageListener()->getNumCoveredLines()));
+    }
+
+    if (mReplaying) {
+        checkReplayedResult(configuration, result);
+        return;
+    }
+
     mWorklist->reprioritize(mAppmodel);
 
+    if (result->isTimedOut()) {
+        qDebug() << "Execution timed out";
+        statistics()->accumulate("Runtime::timed-out-configurations", 1);
+        return;
+    }
+
     long hash;
     if (mOptions.disableStateCheck ||
-            mVisitedStates->find(hash = result->getPageStateHash()) == mVisitedStates->end()) {
+            mVisitedStates->find(hash = result->getAbstractPageStateHash()) == mVisitedStates->end()) {
 
         qDebug() << "Visiting new state";
 
@@ -278,14 +476,40 @@ void Runtime::postConcreteExecution(ExecutableConfigurationConstPtr configuratio
     } else {
         qDebug() << "Page state has already been seen";
     }
+}
 
-    preConcreteExecution();
+/**
+ * Compares the result of a replayed configuration with the recorded one
+ */
+void Runtime::checkReplayedResult(ExecutableConfigurationConstPtr configuration, QSharedPointer<ExecutionResult> result)
+{
+    RunLogEntry recorded = mReplayEntries.take(configuration.data());
+    RunLogEntry replayed(configuration, result, mAppmodel->getCoverageListener()->getNumCoveredLines());
+
+    if (!recorded.matches(replayed)) {
+        qWarning() << "WARN: Replayed execution differs from the run log:" << configuration->toString();
+        qWarning() << "  recorded:" << recorded.toString();
+        qWarning() << "  replayed:" << replayed.toString();
+
+        mReplayMismatches++;
+    }
+
+    statistics()->accumulate("RunLog::replayed-configurations", 1);
 }
 
 void Runtime::finishAnalysis()
 {
+    // MODIFIED by CH
+    // with --pipeline the last result may still be pending, it is part of the coverage and the run log
+    handleDeferredResult();
+
     Log::info("Artemis: Testing done...");
 
+    // MODIFIED by CH
+    if (mTerminating) {
+        Log::info("Terminated: " + mTerminationStrategy->reason().toStdString());
+    }
+
     switch (mOptions.outputCoverage) {
     case HTML:
         writeCoverageHtml(mAppmodel->getCoverageListener());
@@ -312,6 +536,21 @@ void Runtime::finishAnalysis()
 
     statistics()->accumulate("WebKit::coverage::covered-unique", mAppmodel->getCoverageListener()->getNumCoveredLines());
 
+    // MODIFIED by CH
+    if (!mRunLog.isNull()) {
+        mRunLog->finish(mAppmodel->getCoverageListener()->getNumCoveredLines());
+    }
+
+    if (mReplaying) {
+        if (mReplayCoveredLines != mAppmodel->getCoverageListener()->getNumCoveredLines()) {
+            qWarning() << "WARN: The replay covered" << mAppmodel->getCoverageListener()->getNumCoveredLines()
+                       << "lines, the recorded run" << mReplayCoveredLines;
+            mReplayMismatches++;
+        }
+
+        statistics()->accumulate("RunLog::mismatches", mReplayMismatches);
+    }
+
     Log::info("\n=== Statistics ===\n");
     StatsPrettyWriter::write(statistics());
     Log::info("\n=== Statistics END ===\n\n");
@@ -17,6 +17,7 @@
 #ifndef RUNTIME_H_
 #define RUNTIME_H_
 
+#include <QHash>
 #include <QObject>
 #include <QUrl>
 #include <QNetworkProxy>
@@ -30,10 +31,12 @@
 #include "runtime/options.h"
 #include "runtime/worklist/worklist.h"
 #include "runtime/browser/webkitexecutor.h"
+#include "runtime/browser/executorpool.h"
 #include "runtime/browser/executionresult.h"
 #include "runtime/browser/cookies/immutablecookiejar.h"
 #include "runtime/executableconfiguration.h"
 #include "runtime/appmodel.h"
+#include "runtime/runlog.h"
 
 namespace artemis
 {
@@ -58,6 +61,28 @@ private:
 
     AppModelPtr mAppmodel;
     WebKitExecutor* mWebkitExecutor;
+    // MODIFIED by CH
+    // executes the configurations instead of mWebkitExecutor if set
+    ExecutorPool* mExecutorPool;
+    bool mTerminating;
+
+    // with --pipeline the result of the last execution is handled after the next one was started
+    ExecutableConfigurationConstPtr mDeferredConfiguration;
+    QSharedPointer<ExecutionResult> mDeferredResult;
+
+    void handleExecutionResult(ExecutableConfigurationConstPtr configuration, QSharedPointer<ExecutionResult> result);
+    void handleDeferredResult();
+
+    // --record, null if no run is recorded
+    RunLogPtr mRunLog;
+
+    // --replay, the recorded summaries of the configurations still to be handled
+    bool mReplaying;
+    QHash<const ExecutableConfiguration*, RunLogEntry> mReplayEntries;
+    uint mReplayCoveredLines;
+    int mReplayMismatches;
+
+    void checkReplayedResult(ExecutableConfigurationConstPtr configuration, QSharedPointer<ExecutionResult> result);
     WorkListPtr mWorklist;
     set<long>* mVisitedStates;
 
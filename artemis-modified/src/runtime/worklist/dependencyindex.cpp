@@ -0,0 +1,436 @@
+/*
+ * Copyright 2012 Aarhus University
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstring>
+#include <fstream>
+#include <map>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <QString>
+
+#include "dependencyindex.h"
+
+using namespace std;
+
+namespace artemis
+{
+
+static const char COMPILED_MAGIC[] = "ADEP";
+static const quint32 COMPILED_VERSION = 1;
+
+DependencyIndex::DependencyIndex() :
+    mNumEvents(0),
+    mWordsPerRow(0),
+    mNumEdges(0),
+    mNumComponents(0),
+    mClosureEvents(0),
+    mClosureWordsPerRow(0)
+{
+}
+
+/**
+ * Loads the dependencies from either a dep.txt or a dep.txt compiled by src/compiledeps.js. The
+ * format is detected from the content of the file.
+ */
+bool DependencyIndex::load(const string& path)
+{
+    int fd = open(path.c_str(), O_RDONLY);
+
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat info;
+
+    if (fstat(fd, &info) != 0) {
+        close(fd);
+        return false;
+    }
+
+    size_t size = info.st_size;
+    void* data = size > 0 ? mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0) : MAP_FAILED;
+    close(fd);
+
+    if (data == MAP_FAILED) {
+        return loadText(path);
+    }
+
+    bool compiled = size >= 4 && memcmp(data, COMPILED_MAGIC, 4) == 0;
+    bool loaded = compiled && loadCompiled((const char*)data, size);
+
+    munmap(data, size);
+
+    return compiled ? loaded : loadText(path);
+}
+
+/**
+ * Reads dep.txt, which lists dependencies as groups of four lines:
+ *
+ *   dom1, event1, dom2, event2
+ *
+ * meaning that event1 on dom1 influences event2 on dom2. Timers are listed with the event name
+ * "timerinput" and are not bound to a dom element.
+ */
+bool DependencyIndex::loadText(const string& path)
+{
+    ifstream file(path.c_str());
+
+    if (!file.is_open()) {
+        return false;
+    }
+
+    vector<pair<eventkey_t, eventkey_t> > edges;
+    string lines[4];
+    unsigned int cnt = 0;
+
+    while (getline(file, lines[cnt])) {
+        cnt++;
+
+        if (cnt < 4) {
+            continue;
+        }
+
+        cnt = 0;
+
+        QString parent = QString::fromStdString(lines[1]);
+        QString child = QString::fromStdString(lines[3]);
+
+        if (parent != "timerinput") {
+            parent += "@" + QString::fromStdString(lines[0]);
+        }
+
+        if (child != "timerinput") {
+            child += "@" + QString::fromStdString(lines[2]);
+        }
+
+        edges.push_back(make_pair(eventKeys()->intern(parent), eventKeys()->intern(child)));
+    }
+
+    file.close();
+
+    build(edges);
+    return true;
+}
+
+/**
+ * The compiled format (little-endian 32 bit words, see src/compiledeps.js):
+ *
+ *   header          "ADEP", version, numEvents, numEdges, stringBytes, 3 reserved words
+ *   stringOffsets   numEvents + 1 words, offsets of the event keys in the string table
+ *   rowOffsets      numEvents + 1 words, offsets of the successors of each event in targets
+ *   targets         numEdges words
+ *   strings         stringBytes bytes, the UTF-8 event keys
+ *
+ * The event keys are already in the "event@dom" form, so loading only interns each key once and
+ * copies the adjacency array.
+ */
+bool DependencyIndex::loadCompiled(const char* data, size_t size)
+{
+    const size_t headerWords = 8;
+
+    if (size < headerWords * 4) {
+        return false;
+    }
+
+    const quint32* header = (const quint32*)data;
+    quint32 version = header[1];
+    size_t numEvents = header[2];
+    size_t numEdges = header[3];
+    size_t stringBytes = header[4];
+
+    if (version != COMPILED_VERSION ||
+        size != (headerWords + 2 * (numEvents + 1) + numEdges) * 4 + stringBytes) {
+        return false;
+    }
+
+    const quint32* stringOffsets = header + headerWords;
+    const quint32* rowOffsets = stringOffsets + numEvents + 1;
+    const quint32* targets = rowOffsets + numEvents + 1;
+    const char* strings = (const char*)(targets + numEdges);
+
+    if (stringOffsets[numEvents] != stringBytes || rowOffsets[numEvents] != numEdges) {
+        return false;
+    }
+
+    vector<eventkey_t> keys(numEvents);
+
+    for (size_t i = 0; i < numEvents; i++) {
+        if (stringOffsets[i] > stringOffsets[i + 1]) {
+            return false;
+        }
+
+        keys[i] = eventKeys()->intern(QString::fromUtf8(strings + stringOffsets[i], stringOffsets[i + 1] - stringOffsets[i]));
+    }
+
+    vector<pair<eventkey_t, eventkey_t> > edges;
+    edges.reserve(numEdges);
+
+    for (size_t i = 0; i < numEvents; i++) {
+        if (rowOffsets[i] > rowOffsets[i + 1]) {
+            return false;
+        }
+
+        for (quint32 edge = rowOffsets[i]; edge < rowOffsets[i + 1]; edge++) {
+            if (targets[edge] >= numEvents) {
+                return false;
+            }
+
+            edges.push_back(make_pair(keys[i], keys[targets[edge]]));
+        }
+    }
+
+    build(edges);
+    return true;
+}
+
+void DependencyIndex::build(const vector<pair<eventkey_t, eventkey_t> >& edges)
+{
+    mNumEvents = eventKeys()->size();
+    mWordsPerRow = (mNumEvents + 63) / 64;
+    mNumEdges = 0;
+
+    mMatrix.assign((size_t)mNumEvents * mWordsPerRow, 0);
+
+    for (size_t i = 0; i < edges.size(); i++) {
+        quint64& word = mMatrix[edges[i].first * mWordsPerRow + (edges[i].second >> 6)];
+        quint64 bit = Q_UINT64_C(1) << (edges[i].second & 63);
+
+        if ((word & bit) == 0) {
+            word |= bit;
+            mNumEdges++;
+        }
+    }
+}
+
+/**
+ * Returns the first successor of from with an id >= start, or mNumEvents if there is none.
+ */
+eventkey_t DependencyIndex::nextSuccessor(eventkey_t from, eventkey_t start) const
+{
+    const quint64* row = &mMatrix[(size_t)from * mWordsPerRow];
+
+    for (uint word = start >> 6; word < mWordsPerRow; word++) {
+        quint64 bits = row[word];
+
+        if (word == start >> 6) {
+            bits &= ~Q_UINT64_C(0) << (start & 63);
+        }
+
+        if (bits != 0) {
+            return word * 64 + __builtin_ctzll(bits);
+        }
+    }
+
+    return mNumEvents;
+}
+
+/**
+ * Tarjan's algorithm, without recursion as the graphs can be deep.
+ *
+ * Components are numbered in the order they are completed, so every component only has edges to
+ * itself and to components with a lower number.
+ */
+vector<uint> DependencyIndex::strongComponents(uint* numComponents) const
+{
+    const uint unvisited = ~0u;
+
+    vector<uint> component(mNumEvents, unvisited);
+    vector<uint> index(mNumEvents, unvisited);
+    vector<uint> lowlink(mNumEvents, 0);
+    vector<bool> onStack(mNumEvents, false);
+
+    vector<eventkey_t> stack;
+    vector<pair<eventkey_t, eventkey_t> > callStack; // (event, next successor to visit)
+
+    uint counter = 0;
+    *numComponents = 0;
+
+    for (eventkey_t root = 0; root < mNumEvents; root++) {
+
+        if (index[root] != unvisited) {
+            continue;
+        }
+
+        index[root] = lowlink[root] = counter++;
+        stack.push_back(root);
+        onStack[root] = true;
+        callStack.push_back(make_pair(root, 0));
+
+        while (!callStack.empty()) {
+            eventkey_t event = callStack.back().first;
+            eventkey_t successor = nextSuccessor(event, callStack.back().second);
+
+            if (successor < mNumEvents) {
+                callStack.back().second = successor + 1;
+
+                if (index[successor] == unvisited) {
+                    index[successor] = lowlink[successor] = counter++;
+                    stack.push_back(successor);
+                    onStack[successor] = true;
+                    callStack.push_back(make_pair(successor, 0));
+                } else if (onStack[successor]) {
+                    lowlink[event] = qMin(lowlink[event], index[successor]);
+                }
+
+                continue;
+            }
+
+            if (lowlink[event] == index[event]) {
+                eventkey_t member;
+
+                do {
+                    member = stack.back();
+                    stack.pop_back();
+                    onStack[member] = false;
+                    component[member] = *numComponents;
+                } while (member != event);
+
+                (*numComponents)++;
+            }
+
+            callStack.pop_back();
+
+            if (!callStack.empty()) {
+                eventkey_t caller = callStack.back().first;
+                lowlink[caller] = qMin(lowlink[caller], lowlink[event]);
+            }
+        }
+    }
+
+    return component;
+}
+
+void DependencyIndex::computeClosure(bool condensed)
+{
+    vector<uint> component = strongComponents(&mNumComponents);
+
+    vector<vector<eventkey_t> > members(mNumComponents);
+
+    for (eventkey_t event = 0; event < mNumEvents; event++) {
+        members[component[event]].push_back(event);
+    }
+
+    // closure between components; an edge inside a component means the component is a cycle and
+    // its events reach themselves
+    uint componentWords = (mNumComponents + 63) / 64;
+    vector<quint64> reach((size_t)mNumComponents * componentWords, 0);
+
+    for (uint c = 0; c < mNumComponents; c++) {
+        quint64* row = &reach[(size_t)c * componentWords];
+
+        for (size_t i = 0; i < members[c].size(); i++) {
+            eventkey_t event = members[c][i];
+
+            for (eventkey_t successor = nextSuccessor(event, 0); successor < mNumEvents; successor = nextSuccessor(event, successor + 1)) {
+                uint d = component[successor];
+                row[d >> 6] |= Q_UINT64_C(1) << (d & 63);
+
+                if (d != c) {
+                    const quint64* successorRow = &reach[(size_t)d * componentWords];
+
+                    for (uint word = 0; word < componentWords; word++) {
+                        row[word] |= successorRow[word];
+                    }
+                }
+            }
+        }
+    }
+
+    mClosureEvents = mNumEvents;
+    mClosureRows.clear();
+    mClosureRowOf.clear();
+
+    if (condensed) {
+        mClosureColumn = component;
+        mClosureWordsPerRow = componentWords;
+    } else {
+        mClosureColumn.resize(mNumEvents);
+
+        for (eventkey_t event = 0; event < mNumEvents; event++) {
+            mClosureColumn[event] = event;
+        }
+
+        mClosureWordsPerRow = mWordsPerRow;
+    }
+
+    // intern the rows, many events share the same closure (e.g. all events without dependencies)
+    map<vector<quint64>, uint> distinctRows;
+    vector<uint> componentRow(mNumComponents);
+
+    for (uint c = 0; c < mNumComponents; c++) {
+        const quint64* row = &reach[(size_t)c * componentWords];
+        vector<quint64> closure;
+
+        if (condensed) {
+            closure.assign(row, row + componentWords);
+        } else {
+            closure.assign(mWordsPerRow, 0);
+
+            for (uint d = 0; d < mNumComponents; d++) {
+                if ((row[d >> 6] >> (d & 63)) & 1) {
+                    for (size_t i = 0; i < members[d].size(); i++) {
+                        closure[members[d][i] >> 6] |= Q_UINT64_C(1) << (members[d][i] & 63);
+                    }
+                }
+            }
+        }
+
+        map<vector<quint64>, uint>::iterator iter = distinctRows.find(closure);
+
+        if (iter == distinctRows.end()) {
+            iter = distinctRows.insert(make_pair(closure, (uint)distinctRows.size())).first;
+            mClosureRows.insert(mClosureRows.end(), closure.begin(), closure.end());
+        }
+
+        componentRow[c] = iter->second;
+    }
+
+    if (condensed) {
+        mClosureRowOf = componentRow;
+    } else {
+        mClosureRowOf.resize(mNumEvents);
+
+        for (eventkey_t event = 0; event < mNumEvents; event++) {
+            mClosureRowOf[event] = componentRow[component[event]];
+        }
+    }
+}
+
+uint DependencyIndex::numEvents() const
+{
+    return mNumEvents;
+}
+
+uint DependencyIndex::numEdges() const
+{
+    return mNumEdges;
+}
+
+uint DependencyIndex::numComponents() const
+{
+    return mNumComponents;
+}
+
+uint DependencyIndex::numClosureRows() const
+{
+    return mClosureWordsPerRow == 0 ? 0 : mClosureRows.size() / mClosureWordsPerRow;
+}
+
+}
@@ -0,0 +1,118 @@
+/*
+ * Copyright 2012 Aarhus University
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef DEPENDENCYINDEX_H
+#define DEPENDENCYINDEX_H
+
+#include <string>
+#include <vector>
+
+#include <QtGlobal>
+
+#include "runtime/input/eventkeytable.h"
+
+namespace artemis
+{
+
+/**
+ * @brief The DependencyIndex class
+ *
+ * Dense adjacency bit matrix over the event dependencies listed in dep.txt, or in a dep.txt compiled
+ * by src/compiledeps.js, which is mapped into memory instead of parsed. Event keys are
+ * interned through eventKeys(), so a row/column index is the eventkey_t of the event.
+ *
+ * Events interned after the index was loaded are not part of the matrix and have no dependencies.
+ *
+ * computeClosure additionally builds the transitive closure of the relation, answering whether
+ * an event can influence another through any chain of dependencies (reaches). The closure is
+ * computed over the strongly connected components of the graph, and identical rows are stored
+ * only once. In the condensed form the columns are components rather than events, which is much
+ * smaller for graphs with large cycles.
+ */
+class DependencyIndex
+{
+
+public:
+    DependencyIndex();
+
+    bool load(const std::string& path);
+
+    inline bool isDependent(eventkey_t from, eventkey_t to) const
+    {
+        if (from >= mNumEvents || to >= mNumEvents) {
+            return false;
+        }
+
+        return (mMatrix[from * mWordsPerRow + (to >> 6)] >> (to & 63)) & 1;
+    }
+
+    // independence relation of the Mazurkiewicz trace monoid over the events
+    inline bool isIndependent(eventkey_t a, eventkey_t b) const
+    {
+        return a != b && !isDependent(a, b) && !isDependent(b, a);
+    }
+
+    void computeClosure(bool condensed);
+
+    // true if there is a non-empty chain of dependencies from -> ... -> to
+    inline bool reaches(eventkey_t from, eventkey_t to) const
+    {
+        if (from >= mClosureEvents || to >= mClosureEvents) {
+            return false;
+        }
+
+        uint row = mClosureRowOf[mClosureColumn[from]];
+        uint column = mClosureColumn[to];
+
+        return (mClosureRows[(size_t)row * mClosureWordsPerRow + (column >> 6)] >> (column & 63)) & 1;
+    }
+
+    uint numEvents() const;
+    uint numEdges() const;
+    uint numComponents() const;
+    uint numClosureRows() const;
+
+private:
+    bool loadText(const std::string& path);
+    bool loadCompiled(const char* data, size_t size);
+    void build(const std::vector<std::pair<eventkey_t, eventkey_t> >& edges);
+
+    eventkey_t nextSuccessor(eventkey_t from, eventkey_t start) const;
+    std::vector<uint> strongComponents(uint* numComponents) const;
+
+    uint mNumEvents;
+    uint mWordsPerRow;
+    uint mNumEdges;
+
+    // row-major, mNumEvents x mWordsPerRow words
+    std::vector<quint64> mMatrix;
+
+    uint mNumComponents;
+    uint mClosureEvents;
+    uint mClosureWordsPerRow;
+
+    // event -> closure column, the component of the event in the condensed form, else the event
+    std::vector<uint> mClosureColumn;
+
+    // closure column -> row in mClosureRows
+    std::vector<uint> mClosureRowOf;
+
+    // distinct closure rows, mClosureWordsPerRow words each
+    std::vector<quint64> mClosureRows;
+};
+
+}
+
+#endif // DEPENDENCYINDEX_H
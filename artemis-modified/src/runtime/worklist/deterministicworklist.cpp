@@ -14,9 +14,16 @@
  * limitations under the License.
  */
 
+#include <algorithm>
 #include <stdlib.h>
-#include <unistd.h>
 #include <sys/time.h>
+
+#include <QDataStream>
+#include <QDebug>
+#include <QDir>
+
+#include "statistics/statsstorage.h"
+
 #include "deterministicworklist.h"
 
 extern int testType;
@@ -29,10 +36,28 @@ extern double totaltime2;
 namespace artemis
 {
 
-DeterministicWorkList::DeterministicWorkList(PrioritizerStrategyPtr prioritizer) :
+DeterministicWorkList::DeterministicWorkList(PrioritizerStrategyPtr prioritizer, bool condenseDependencies,
+                                             DuplicateFilters duplicateFilter) :
     WorkList(),
-    mPrioritizer(prioritizer)
+    mPrioritizer(prioritizer),
+    mNextOrder(0),
+    mCondenseDependencies(condenseDependencies),
+    mDuplicateFilter(duplicateFilter),
+    mSeenConfigurations(duplicateFilter == DUPLICATES_BLOOM),
+    mMemoryLimit(0),
+    mSpillFile(QDir::tempPath() + "/artemis-worklist-XXXXXX"),
+    mReloadedBytes(0)
+{
+}
+
+/**
+ * Keeps at most memoryLimit configurations in memory, the rest is written to a temporary file
+ * using serializer. A memoryLimit of 0 disables spilling.
+ */
+void DeterministicWorkList::enableSpilling(int memoryLimit, InputSerializerPtr serializer)
 {
+    mMemoryLimit = memoryLimit;
+    mSerializer = serializer;
 }
 // MODIFIED by CH
 void DeterministicWorkList::add(ExecutableConfigurationConstPtr configuration, AppModelConstPtr appmodel, string dependencyString)
@@ -45,58 +70,26 @@ void DeterministicWorkList::add(ExecutableConfigurationConstPtr configuration, A
     double minus = 0;
     gettimeofday(&curT1_1, NULL);
     totalTry ++;
-    if (testType == 1) {
-        // Just check very last two sequence and judge whether it will be added or not
-        string addingWorklist = configuration-> getSequence().toStdString();
-        istringstream ss(addingWorklist);
-        string token;
-        vector<string> eventSequence;
-        while (getline(ss, token, ',')) {
-            eventSequence.push_back(token);
-        }
-        int size = eventSequence.size();
-
-        if (size>1) {
-            // Last sequence of Dom1 & Dom2
-            string dom1 = eventSequence[size-2];
-            string dom2 = eventSequence[size-1];
-            vector <string> reachableSet = reachableMap[dom1];
-            //cout << dom1 << "\n";
-            //cout << dom2 << "\n";
-            /*
-            for (std::vector<string>::const_iterator i = reachableSet.begin(); i != reachableSet.end(); ++i)
-                std::cout << *i << ' ';
-                */
-
-            if (std::find(reachableSet.begin(), reachableSet.end(), dom2) != reachableSet.end()) {
-                gettimeofday(&curT2_1, NULL);
-                mQueue.push(WorkListItem(mPrioritizer->prioritize(configuration, appmodel), configuration));
-                gettimeofday(&curT2_2, NULL);
-                minus= (curT2_2.tv_sec - curT2_1.tv_sec) * 1000.0f + (curT2_2.tv_usec - curT2_1.tv_usec) / 1000.0f;
-            } else {
-                blockedCnt++;
-                vector <string> reachableSet2 = reachableMap[dom2];
-                // if there is not dependent relationship and if that is the lexical order then insert it.
-                if (dom2.compare(dom1) > 0 && std::find(reachableSet2.begin(), reachableSet2.end(), dom1) == reachableSet2.end()) {
-                    gettimeofday(&curT2_1, NULL);
-                    mQueue.push(WorkListItem(mPrioritizer->prioritize(configuration, appmodel), configuration));
-                    gettimeofday(&curT2_2, NULL);
-                    minus= (curT2_2.tv_sec - curT2_1.tv_sec) * 1000.0f + (curT2_2.tv_usec - curT2_1.tv_usec) / 1000.0f;
-                } else {
-                    blockedCnt2++;
-                }
 
-            }
-        } else {
-            string addingWorklist = configuration-> getSequence().toStdString();
-            gettimeofday(&curT2_1, NULL);
-            mQueue.push(WorkListItem(mPrioritizer->prioritize(configuration, appmodel), configuration));
-            gettimeofday(&curT2_2, NULL);
-            minus= (curT2_2.tv_sec - curT2_1.tv_sec) * 1000.0f + (curT2_2.tv_usec - curT2_1.tv_usec) / 1000.0f;
-        }
-    } else {
+    mAppModel = appmodel;
+
+    bool accepted = true;
+
+    if (mDuplicateFilter != DUPLICATES_KEEP && !mSeenConfigurations.insert(configuration->getFingerprint())) {
+        // the same sequence was added before, executing it again would not find anything new
+        statistics()->accumulate("WorkList::duplicates-skipped", 1);
+        accepted = false;
+    } else if (testType == 1) {
+        accepted = acceptDependent(*configuration->getInputSequence());
+    } else if (testType == 2) {
+        accepted = acceptReachable(*configuration->getInputSequence());
+    } else if (testType == 3) {
+        accepted = acceptTraceNormalForm(*configuration->getInputSequence());
+    }
+
+    if (accepted) {
         gettimeofday(&curT2_1, NULL);
-        mQueue.push(WorkListItem(mPrioritizer->prioritize(configuration, appmodel), configuration));
+        insert(configuration, appmodel);
         gettimeofday(&curT2_2, NULL);
         minus= (curT2_2.tv_sec - curT2_1.tv_sec) * 1000.0f + (curT2_2.tv_usec - curT2_1.tv_usec) / 1000.0f;
     }
@@ -107,121 +100,471 @@ void DeterministicWorkList::add(ExecutableConfigurationConstPtr configuration, A
 
 }
 
+// MODIFIED by CH
+// Just check very last two sequence and judge whether it will be added or not
+bool DeterministicWorkList::acceptDependent(const InputSequence& eventSequence)
+{
+    if (eventSequence.size() <= 1) {
+        return true;
+    }
+
+    // Last sequence of Dom1 & Dom2
+    InputSequence::const_reverse_iterator iter = eventSequence.rbegin();
+    eventkey_t dom2 = (iter++).eventKey();
+    eventkey_t dom1 = iter.eventKey();
+
+    if (mDependencies.isDependent(dom1, dom2)) {
+        return true;
+    }
+
+    blockedCnt++;
+    // if there is not dependent relationship and if that is the lexical order then insert it.
+    if (eventKeys()->name(dom2).compare(eventKeys()->name(dom1)) > 0 && !mDependencies.isDependent(dom2, dom1)) {
+        return true;
+    }
+
+    blockedCnt2++;
+    return false;
+}
+
+// MODIFIED by CH
+// Same as acceptDependent, but on the transitive closure of dep.txt. On top of that, a last event
+// which can not be influenced by any earlier event of a longer prefix is rejected, the sequence
+// without the prefix is explored anyway.
+bool DeterministicWorkList::acceptReachable(const InputSequence& eventSequence)
+{
+    int size = eventSequence.size();
+
+    if (size <= 1) {
+        return true;
+    }
+
+    InputSequence::const_reverse_iterator iter = eventSequence.rbegin();
+    eventkey_t dom2 = (iter++).eventKey();
+    eventkey_t dom1 = (iter++).eventKey();
+
+    if (mDependencies.reaches(dom1, dom2)) {
+        return true;
+    }
+
+    blockedCnt++;
+
+    if (eventKeys()->name(dom2).compare(eventKeys()->name(dom1)) > 0 && !mDependencies.reaches(dom2, dom1)) {
+        bool influenced = size == 2;
+
+        for (; iter != eventSequence.rend() && !influenced; ++iter) {
+            influenced = mDependencies.reaches(iter.eventKey(), dom2);
+        }
+
+        if (influenced) {
+            return true;
+        }
+
+        statistics()->accumulate("WorkList::unreachable-skipped", 1);
+    }
+
+    blockedCnt2++;
+    return false;
+}
+
+// MODIFIED by CH
+// Partial-order reduction. Sequences which only differ by swapping adjacent independent events
+// (no dependency in either direction in dep.txt) lead to the same state, so only one sequence of
+// each such equivalence class (Mazurkiewicz trace) is executed: the lexicographically smallest,
+// comparing events by name.
+//
+// A sequence is the smallest of its trace iff no event can be moved in front of a larger event it
+// is independent of, past events it is independent of as well. The prefix was accepted before (it
+// was extended after being executed), so only the last event has to be checked. This is the
+// same set of sequences a sleep-set search with the same order would explore.
+bool DeterministicWorkList::acceptTraceNormalForm(const InputSequence& eventSequence)
+{
+    if (eventSequence.size() <= 1) {
+        return true;
+    }
+
+    InputSequence::const_reverse_iterator iter = eventSequence.rbegin();
+    eventkey_t last = (iter++).eventKey();
+
+    if (!mDependencies.isIndependent(iter.eventKey(), last)) {
+        return true;
+    }
+
+    blockedCnt++;
+
+    QString lastName = eventKeys()->name(last);
+
+    for (; iter != eventSequence.rend(); ++iter) {
+        eventkey_t event = iter.eventKey();
+
+        if (!mDependencies.isIndependent(event, last)) {
+            return true;
+        }
+
+        if (lastName.compare(eventKeys()->name(event)) < 0) {
+            statistics()->accumulate("WorkList::por-skipped", 1);
+            blockedCnt2++;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void DeterministicWorkList::insert(ExecutableConfigurationConstPtr configuration, AppModelConstPtr appmodel)
+{
+    WorkListEntry* entry = new WorkListEntry(mPrioritizer->prioritize(configuration, appmodel), mNextOrder++, configuration);
+
+    index(entry);
+
+    mQueue.push(entry);
+
+    if (mMemoryLimit > 0 && mQueue.size() > mMemoryLimit) {
+        spill();
+    }
+}
+
+void DeterministicWorkList::index(WorkListEntry* entry)
+{
+    InputSequenceConstPtr sequence = entry->configuration->getInputSequence();
+
+    for (InputSequence::const_reverse_iterator input = sequence->rbegin(); input != sequence->rend(); ++input) {
+        mEntriesByInput[input->hashCode()].insert(entry);
+    }
+}
+
+void DeterministicWorkList::unindex(WorkListEntry* entry)
+{
+    InputSequenceConstPtr sequence = entry->configuration->getInputSequence();
+
+    for (InputSequence::const_reverse_iterator input = sequence->rbegin(); input != sequence->rend(); ++input) {
+        QHash<int, QSet<WorkListEntry*> >::iterator iter = mEntriesByInput.find(input->hashCode());
+
+        if (iter != mEntriesByInput.end()) {
+            iter.value().remove(entry);
+
+            if (iter.value().isEmpty()) {
+                mEntriesByInput.erase(iter);
+            }
+        }
+    }
+}
+
 ExecutableConfigurationConstPtr DeterministicWorkList::remove()
 {
-    Q_ASSERT(!mQueue.empty());
+    Q_ASSERT(!empty());
+
+    if (!mSpilled.empty() && (mQueue.empty() || mSpilled.front().priority > mQueue.top()->priority)) {
+        reload();
+    }
+
+    WorkListEntry* entry = mQueue.pop();
+    ExecutableConfigurationConstPtr configuration = entry->configuration;
 
-    ExecutableConfigurationConstPtr configuration = mQueue.top().second;
-    mQueue.pop();
+    unindex(entry);
+    delete entry;
 
     return configuration;
 }
 
+/**
+ * Moves the lower half of the in-memory configurations to the end of the spill file.
+ */
+void DeterministicWorkList::spill()
+{
+    if (!mSpillFile.isOpen() && !mSpillFile.open()) {
+        qWarning() << "WorkList: could not open spill file" << mSpillFile.fileName() << ", keeping everything in memory";
+        mMemoryLimit = 0;
+        return;
+    }
+
+    std::vector<WorkListEntry*> entries = mQueue.takeAll();
+    size_t keep = qMax(mMemoryLimit / 2, 1);
+
+    std::nth_element(entries.begin(), entries.begin() + keep, entries.end(), WorkListHeap::before);
+
+    for (size_t i = 0; i < keep; i++) {
+        mQueue.push(entries[i]);
+    }
+
+    mSpillFile.seek(mSpillFile.size());
+
+    QDataStream stream(&mSpillFile);
+    stream.setVersion(QDataStream::Qt_4_8);
+
+    for (size_t i = keep; i < entries.size(); i++) {
+        WorkListEntry* entry = entries[i];
+
+        SpilledEntry spilled;
+        spilled.priority = entry->priority;
+        spilled.order = entry->order;
+        spilled.offset = mSpillFile.pos();
+
+        mSerializer->write(stream, entry->configuration);
+        spilled.length = mSpillFile.pos() - spilled.offset;
+
+        mSpilled.push_back(spilled);
+        std::push_heap(mSpilled.begin(), mSpilled.end(), spilledAfter);
+
+        unindex(entry);
+        delete entry;
+    }
+
+    mSpillFile.flush();
+
+    statistics()->accumulate("WorkList::spilled", (int)(entries.size() - keep));
+}
+
+/**
+ * Reads back the best half memory limit of the spilled configurations. They are read in file
+ * order, so the reads are mostly sequential.
+ */
+void DeterministicWorkList::reload()
+{
+    size_t batch = qMin((size_t)qMax(mMemoryLimit / 2, 1), mSpilled.size());
+    std::vector<SpilledEntry> entries;
+
+    for (size_t i = 0; i < batch; i++) {
+        std::pop_heap(mSpilled.begin(), mSpilled.end(), spilledAfter);
+        entries.push_back(mSpilled.back());
+        mSpilled.pop_back();
+    }
+
+    std::sort(entries.begin(), entries.end(), byOffset);
+
+    for (size_t i = 0; i < entries.size(); i++) {
+        ExecutableConfigurationConstPtr configuration = readSpilled(entries[i].offset);
+        mReloadedBytes += entries[i].length;
+
+        if (configuration.isNull()) {
+            qWarning() << "WorkList: could not read spilled configuration at offset" << entries[i].offset;
+            continue;
+        }
+
+        double priority = mAppModel.isNull() ? entries[i].priority : mPrioritizer->prioritize(configuration, mAppModel);
+        WorkListEntry* entry = new WorkListEntry(priority, entries[i].order, configuration);
+
+        index(entry);
+
+        mQueue.push(entry);
+    }
+
+    if (mSpilled.empty()) {
+        mSpillFile.resize(0);
+        mReloadedBytes = 0;
+    } else if (mReloadedBytes * 2 > mSpillFile.size()) {
+        compact();
+    }
+
+    statistics()->accumulate("WorkList::reloaded", (int)entries.size());
+}
+
+/**
+ * Moves the configurations still spilled to the front of the spill file, in file order, and cuts
+ * off the rest. Each one is moved to a lower offset, so the file is compacted in place.
+ */
+void DeterministicWorkList::compact()
+{
+    std::sort(mSpilled.begin(), mSpilled.end(), byOffset);
+
+    qint64 end = 0;
+    bool moved = true;
+
+    for (size_t i = 0; i < mSpilled.size(); i++) {
+        SpilledEntry& entry = mSpilled[i];
+
+        if (entry.offset != end) {
+            QByteArray data;
+
+            moved = mSpillFile.seek(entry.offset) && (data = mSpillFile.read(entry.length)).size() == entry.length &&
+                    mSpillFile.seek(end) && mSpillFile.write(data) == entry.length;
+
+            if (!moved) {
+                // this entry and the ones after it are still at their old offsets
+                qWarning() << "WorkList: could not compact spill file" << mSpillFile.fileName();
+                break;
+            }
+
+            entry.offset = end;
+        }
+
+        end += entry.length;
+    }
+
+    std::make_heap(mSpilled.begin(), mSpilled.end(), spilledAfter);
+
+    if (moved) {
+        mSpillFile.flush();
+        mSpillFile.resize(end);
+        mReloadedBytes = 0;
+
+        statistics()->accumulate("WorkList::spill-compactions", 1);
+    }
+}
+
+ExecutableConfigurationConstPtr DeterministicWorkList::readSpilled(qint64 offset) const
+{
+    if (!mSpillFile.seek(offset)) {
+        return ExecutableConfigurationConstPtr();
+    }
+
+    QDataStream stream(&mSpillFile);
+    stream.setVersion(QDataStream::Qt_4_8);
+
+    return mSerializer->readConfiguration(stream);
+}
+
+/**
+ * The priority of a configuration only depends on the statistics collected for its own inputs, so
+ * only configurations containing an input whose statistics changed since the last call are
+ * rescored. Prioritizers that are not incremental (e.g. random) still rescore everything.
+ */
 void DeterministicWorkList::reprioritize(AppModelConstPtr appmodel)
 {
-    QList<WorkListItem> tmps;
+    QSet<int> changedInputs = appmodel->getCoverageListener()->takeChangedInputs();
+    changedInputs.unite(appmodel->getJavascriptStatistics()->takeChangedInputs());
+
+    if (!mPrioritizer->isIncremental()) {
+        QList<WorkListEntry*> entries;
+
+        while (!mQueue.empty()) {
+            entries.append(mQueue.pop());
+        }
+
+        foreach (WorkListEntry* entry, entries) {
+            entry->priority = mPrioritizer->prioritize(entry->configuration, appmodel);
+            mQueue.push(entry);
+        }
 
-    while (!mQueue.empty()) {
-        tmps.append(mQueue.top());
-        mQueue.pop();
+        statistics()->accumulate("WorkList::rescored", entries.size());
+        return;
     }
 
-    foreach (WorkListItem item, tmps) {
-        item.first = mPrioritizer->prioritize(item.second, appmodel);
-        mQueue.push(item);
+    QSet<WorkListEntry*> dirty;
+
+    foreach (int inputHash, changedInputs) {
+        QHash<int, QSet<WorkListEntry*> >::const_iterator iter = mEntriesByInput.constFind(inputHash);
+
+        if (iter != mEntriesByInput.constEnd()) {
+            dirty.unite(iter.value());
+        }
     }
+
+    foreach (WorkListEntry* entry, dirty) {
+        mQueue.update(entry, mPrioritizer->prioritize(entry->configuration, appmodel));
+    }
+
+    statistics()->accumulate("WorkList::rescored", dirty.size());
 }
 
 int DeterministicWorkList::size()
 {
-    return mQueue.size();
+    return mQueue.size() + mSpilled.size();
 }
 
 bool DeterministicWorkList::empty()
 {
-    return mQueue.empty();
+    return mQueue.empty() && mSpilled.empty();
 }
 
 // MODIFIED by CH
-void DeterministicWorkList::readFile(QUrl url)
-{
-    string line;
-    /*
-    TODO: I have to set directory path based on url
-    cout << "readfile!\n";
-    cout << url.toString().toStdString(); 
-    cout << "\n";
-    */
-    // get file Path of dep.txt 
-    char *path = NULL;
-    size_t size= 200;
-    path = getcwd(path,size);
-    char filePath[200];
-    cout << path << "\n";
-    strcpy(filePath, path);
-    strcat(filePath, "/dep.txt");
-    unsigned int cnt = 0;
+void DeterministicWorkList::readFile(const QString& path)
+{
+    cout << path.toStdString() << "\n";
     // open file and saving data
-    ifstream myfile(filePath);
-    string dom1, event1, dom2, event2;
-    string parent, child;
-    if (myfile.is_open()) {
-        while (getline(myfile,line)) {
-            istringstream base(line);
-            string index;
-            if (cnt == 0) {
-                dom1 = line;
-            } else if (cnt == 1) {
-                event1 = line;
-            } else if (cnt == 2) {
-                dom2 = line;
-            } else if (cnt == 3) {
-                event2 = line;
-            }
-            cnt ++;
-            if (cnt == 4) {
-                cnt = 0;
-                if (event1.compare("timerinput") == 0) {
-                    parent = event1; 
-                } else {
-                    parent = event1 + "@" + dom1;
-                }
-                if (event2.compare("timerinput") == 0) {
-                    child = event2; 
-                } else {
-                    child = event2 + "@" + dom2;
-                }
-                //cout << parent + ", " + child + "\n";
-                reachableMap[parent].push_back(child);
-            }
-        }
-        myfile.close();
-    } else {
+    if (!mDependencies.load(path.toStdString())) {
         cout << "Unable to open file\n"; 
     } 
+
+    if (testType == 2) {
+        mDependencies.computeClosure(mCondenseDependencies);
+        cout << "Closure: " << mDependencies.numEvents() << " events, " << mDependencies.numComponents()
+             << " components, " << mDependencies.numClosureRows() << " distinct rows\n";
+    }
+
     cout << "Read done!!!\n";
 }
 
-QString DeterministicWorkList::toString() const
+// MODIFIED by CH
+QList<WorkListItem> DeterministicWorkList::snapshot() const
 {
-    // We can't iterate over a priority_queue, thus the ugliness here
-    // TODO find a priority_queue implementation supporting iteration
+    std::vector<const WorkListEntry*> entries = mQueue.snapshot();
+    QList<WorkListItem> items;
 
-    QList<WorkListItem> tmps;
+    items.reserve(entries.size());
 
-    while (!mQueue.empty()) {
-        tmps.append(mQueue.top());
-        mQueue.pop();
+    for (size_t i = 0; i < entries.size(); i++) {
+        items.append(WorkListItem(entries[i]->priority, entries[i]->configuration));
     }
 
+    return items;
+}
+
+QList<SpilledWorkListItem> DeterministicWorkList::spilledSnapshot() const
+{
+    std::vector<SpilledEntry> spilled(mSpilled);
+    std::sort(spilled.begin(), spilled.end(), spilledAfter);
+
+    QList<SpilledWorkListItem> items;
+
+    items.reserve(spilled.size());
+
+    // sorted with the entry read back first at the end
+    for (size_t i = spilled.size(); i > 0; i--) {
+        SpilledWorkListItem item = {spilled[i - 1].priority, spilled[i - 1].offset};
+        items.append(item);
+    }
+
+    return items;
+}
+
+// Spilled configurations are not read back, they are only listed by priority and offset
+QString DeterministicWorkList::toString() const
+{
     QString output;
 
-    foreach (WorkListItem item, tmps) {
-        mQueue.push(item);
-        output += QString::number(item.first) + QString(" => ") + item.second->toString() + QString("\n");
+    foreach (listed_t entry, listEntries()) {
+        QString configuration = entry.second < 0 ? entry.first.second->toString()
+                                                 : QString("<spilled at offset ") + QString::number(entry.second) + QString(">");
+        QString priority = QString::number(entry.first.first) + QString(entry.second < 0 ? "" : " (stale)");
+        output += priority + QString(" => ") + configuration + QString("\n");
     }
 
     return output;
 }
 
+QList<DeterministicWorkList::listed_t> DeterministicWorkList::listEntries() const
+{
+    std::vector<const WorkListEntry*> entries = mQueue.snapshot();
+    QList<listed_t> items;
+
+    items.reserve(entries.size() + mSpilled.size());
+
+    // spilled configurations are listed with the priority they had when they were spilled
+    std::vector<SpilledEntry> spilled(mSpilled);
+    std::sort(spilled.begin(), spilled.end(), spilledAfter);
+
+    size_t next = 0;
+
+    while (next < entries.size() || !spilled.empty()) {
+        bool fromMemory = spilled.empty();
+
+        if (!fromMemory && next < entries.size()) {
+            SpilledEntry entry = {entries[next]->priority, entries[next]->order, 0, 0};
+            fromMemory = spilledAfter(spilled.back(), entry);
+        }
+
+        if (fromMemory) {
+            items.append(listed_t(WorkListItem(entries[next]->priority, entries[next]->configuration), -1));
+            next++;
+            continue;
+        }
+
+        items.append(listed_t(WorkListItem(spilled.back().priority, ExecutableConfigurationConstPtr()), spilled.back().offset));
+        spilled.pop_back();
+    }
+
+    return items;
+}
+
 }
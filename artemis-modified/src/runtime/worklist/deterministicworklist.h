@@ -16,41 +16,49 @@
 #ifndef DETERMINISTICWORKLIST_H
 #define DETERMINISTICWORKLIST_H
 
-#include <queue>
 #include <vector>
 
-#include <QPair>
+#include <QHash>
+#include <QSet>
+#include <QTemporaryFile>
 
 #include "strategies/prioritizer/prioritizerstrategy.h"
 
 #include "worklist.h"
 // MODIFIED by CH
 #include <iostream>
-#include <sstream>
-#include <fstream>
 #include <string>
-#include <map>
 
-using namespace std;
+#include "runtime/options.h"
+#include "runtime/input/inputserializer.h"
 
-namespace artemis
-{
+#include "dependencyindex.h"
+#include "fingerprintset.h"
+#include "worklistheap.h"
 
-typedef QPair<double, ExecutableConfigurationConstPtr> WorkListItem;
+using namespace std;
 
-struct WorkListItemComperator
+namespace artemis
 {
-    bool operator() (const WorkListItem& lhs, const WorkListItem& rhs)
-    {
-        return lhs.first < rhs.first;
-    }
-};
 
+/**
+ * @brief The DeterministicWorkList class
+ *
+ * Priority queue of configurations, ties are removed in insertion order.
+ *
+ * With enableSpilling at most memoryLimit configurations are kept in memory. When the limit is
+ * exceeded, the lower half is written to a temporary segment file and only their priority and
+ * file offset stay in memory. Spilled configurations are read back in batches once they would be
+ * the next to be removed, and rescored when read back, as their statistics may have changed. The
+ * segment file is compacted once most of it was read back.
+ */
 class DeterministicWorkList : public WorkList
 {
 public:
-    DeterministicWorkList(PrioritizerStrategyPtr prioritizer);
+    DeterministicWorkList(PrioritizerStrategyPtr prioritizer, bool condenseDependencies = false,
+                          DuplicateFilters duplicateFilter = DUPLICATES_KEEP);
 
+    void enableSpilling(int memoryLimit, InputSerializerPtr serializer);
 
     void add(ExecutableConfigurationConstPtr configuration, AppModelConstPtr appmodel, string dependencyString);
     ExecutableConfigurationConstPtr remove();
@@ -61,18 +69,81 @@ public:
     bool empty();
 
     // MODIFIED by CH
-    void readFile(QUrl);
+    void readFile(const QString& path);
+
+    QList<WorkListItem> snapshot() const;
+    QList<SpilledWorkListItem> spilledSnapshot() const;
 
     QString toString() const;
 
 private:
-    // mutable here is a hack to support toString
-    mutable priority_queue<WorkListItem, vector<WorkListItem>, WorkListItemComperator> mQueue;
+    void insert(ExecutableConfigurationConstPtr configuration, AppModelConstPtr appmodel);
+
+    // MODIFIED by CH
+    bool acceptDependent(const InputSequence& eventSequence);
+    bool acceptReachable(const InputSequence& eventSequence);
+    bool acceptTraceNormalForm(const InputSequence& eventSequence);
+
+    struct SpilledEntry
+    {
+        double priority;
+        quint64 order;
+        qint64 offset;
+        qint64 length;
+    };
+
+    // heap order for mSpilled, the entry removed first is on top
+    static inline bool spilledAfter(const SpilledEntry& lhs, const SpilledEntry& rhs)
+    {
+        if (lhs.priority != rhs.priority) {
+            return lhs.priority < rhs.priority;
+        }
+
+        return lhs.order > rhs.order;
+    }
+
+    static inline bool byOffset(const SpilledEntry& lhs, const SpilledEntry& rhs)
+    {
+        return lhs.offset < rhs.offset;
+    }
+
+    void index(WorkListEntry* entry);
+    void unindex(WorkListEntry* entry);
+    void spill();
+    void reload();
+    void compact();
+    ExecutableConfigurationConstPtr readSpilled(qint64 offset) const;
+
+    // all entries in removal order, with the file offset of spilled ones (-1 for the others), whose
+    // configuration is null
+    typedef QPair<WorkListItem, qint64> listed_t; // workaround for foreach comma bug
+    QList<listed_t> listEntries() const;
+
+    WorkListHeap mQueue;
     PrioritizerStrategyPtr mPrioritizer;
+    quint64 mNextOrder;
+
+    // inputHashCode -> entries whose sequence contains the input
+    QHash<int, QSet<WorkListEntry*> > mEntriesByInput;
 
     // MODIFIED by CH
-    map< string, vector<string> > reachableMap;
+    DependencyIndex mDependencies;
+    bool mCondenseDependencies;
+
+    // fingerprints of all configurations ever added, unless mDuplicateFilter is DUPLICATES_KEEP
+    DuplicateFilters mDuplicateFilter;
+    FingerprintSet mSeenConfigurations;
+
+    // 0 if all configurations are kept in memory
+    int mMemoryLimit;
+    InputSerializerPtr mSerializer;
+    AppModelConstPtr mAppModel;
+
+    mutable QTemporaryFile mSpillFile;
+    std::vector<SpilledEntry> mSpilled;
 
+    // bytes of the spill file taken by configurations which were read back
+    qint64 mReloadedBytes;
 };
 
 }
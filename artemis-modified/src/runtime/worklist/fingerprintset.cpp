@@ -0,0 +1,164 @@
+/*
+ * Copyright 2012 Aarhus University
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "fingerprintset.h"
+
+namespace artemis
+{
+
+static const size_t INITIAL_SLOTS = 1024;
+
+// 2^24 bits (2 MB), about 1% of the new sequences probe the table at 1.7 million sequences
+static const uint BLOOM_BITS_LOG2 = 24;
+static const uint BLOOM_PROBES = 4;
+
+// double hashing, the fingerprints are well mixed so their two halves serve as the hash functions
+static inline quint64 bloomBit(fingerprint_t fingerprint, uint probe)
+{
+    quint64 step = (fingerprint >> 32) | 1;
+    return (fingerprint + probe * step) & ((Q_UINT64_C(1) << BLOOM_BITS_LOG2) - 1);
+}
+
+FingerprintSet::FingerprintSet(bool bloom) :
+    mBloom(bloom),
+    mSize(0)
+{
+}
+
+bool FingerprintSet::insert(fingerprint_t fingerprint)
+{
+    // 0 marks empty slots
+    if (fingerprint == 0) {
+        fingerprint = 1;
+    }
+
+    // the table only has to be probed if the filter may have seen the fingerprint
+    bool probe = !mBloom || !insertBloom(fingerprint);
+
+    return insertExact(fingerprint, probe);
+}
+
+bool FingerprintSet::contains(fingerprint_t fingerprint) const
+{
+    if (fingerprint == 0) {
+        fingerprint = 1;
+    }
+
+    if (mTable.empty() || (mBloom && !containsBloom(fingerprint))) {
+        return false;
+    }
+
+    size_t mask = mTable.size() - 1;
+
+    for (size_t slot = fingerprint & mask; mTable[slot] != 0; slot = (slot + 1) & mask) {
+        if (mTable[slot] == fingerprint) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+uint FingerprintSet::size() const
+{
+    return mSize;
+}
+
+/**
+ * Without probe the fingerprint is known to be new, only a free slot is searched for.
+ */
+bool FingerprintSet::insertExact(fingerprint_t fingerprint, bool probe)
+{
+    // keep the load factor below 1/2
+    if ((mSize + 1) * 2 > mTable.size()) {
+        grow();
+    }
+
+    size_t mask = mTable.size() - 1;
+    size_t slot = fingerprint & mask;
+
+    while (mTable[slot] != 0) {
+        if (probe && mTable[slot] == fingerprint) {
+            return false;
+        }
+
+        slot = (slot + 1) & mask;
+    }
+
+    mTable[slot] = fingerprint;
+    mSize++;
+
+    return true;
+}
+
+// returns true if the filter had not seen the fingerprint
+bool FingerprintSet::insertBloom(fingerprint_t fingerprint)
+{
+    if (mFilter.empty()) {
+        mFilter.assign((size_t(1) << BLOOM_BITS_LOG2) / 64, 0);
+    }
+
+    bool present = true;
+
+    for (uint i = 0; i < BLOOM_PROBES; i++) {
+        quint64 bit = bloomBit(fingerprint, i);
+        quint64& word = mFilter[bit >> 6];
+        quint64 mask = Q_UINT64_C(1) << (bit & 63);
+
+        if ((word & mask) == 0) {
+            present = false;
+            word |= mask;
+        }
+    }
+
+    return !present;
+}
+
+bool FingerprintSet::containsBloom(fingerprint_t fingerprint) const
+{
+    for (uint i = 0; i < BLOOM_PROBES; i++) {
+        quint64 bit = bloomBit(fingerprint, i);
+
+        if (((mFilter[bit >> 6] >> (bit & 63)) & 1) == 0) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void FingerprintSet::grow()
+{
+    std::vector<quint64> old;
+    old.swap(mTable);
+
+    mTable.assign(old.empty() ? INITIAL_SLOTS : old.size() * 2, 0);
+    size_t mask = mTable.size() - 1;
+
+    for (size_t i = 0; i < old.size(); i++) {
+        if (old[i] != 0) {
+            size_t slot = old[i] & mask;
+
+            while (mTable[slot] != 0) {
+                slot = (slot + 1) & mask;
+            }
+
+            mTable[slot] = old[i];
+        }
+    }
+}
+
+}
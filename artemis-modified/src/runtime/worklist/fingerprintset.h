@@ -0,0 +1,68 @@
+/*
+ * Copyright 2012 Aarhus University
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef FINGERPRINTSET_H
+#define FINGERPRINTSET_H
+
+#include <vector>
+
+#include <QtGlobal>
+
+#include "util/fingerprintutil.h"
+
+namespace artemis
+{
+
+/**
+ * @brief The FingerprintSet class
+ *
+ * Set of sequence fingerprints, used by the worklist to recognize sequences it has seen before.
+ *
+ * The set is an open addressing hash table with linear probing. The bloom variant puts a Bloom
+ * filter of fixed size in front of it: fingerprints the filter has not seen are new without probing
+ * the table, and a hit of the filter is confirmed against the table, so no fingerprint is ever
+ * reported as seen by mistake.
+ */
+class FingerprintSet
+{
+
+public:
+    FingerprintSet(bool bloom);
+
+    // returns false if the fingerprint was already in the set
+    bool insert(fingerprint_t fingerprint);
+    bool contains(fingerprint_t fingerprint) const;
+
+    uint size() const;
+
+private:
+    bool insertExact(fingerprint_t fingerprint, bool probe);
+    bool insertBloom(fingerprint_t fingerprint);
+    bool containsBloom(fingerprint_t fingerprint) const;
+    void grow();
+
+    bool mBloom;
+    uint mSize;
+
+    // power of two number of slots, 0 marks an empty slot
+    std::vector<quint64> mTable;
+
+    // the bits of the filter, empty unless mBloom
+    std::vector<quint64> mFilter;
+};
+
+}
+
+#endif // FINGERPRINTSET_H
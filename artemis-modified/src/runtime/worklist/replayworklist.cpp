@@ -0,0 +1,78 @@
+/*
+ * Copyright 2012 Aarhus University
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "replayworklist.h"
+
+namespace artemis
+{
+
+ReplayWorkList::ReplayWorkList(const QList<ExecutableConfigurationConstPtr>& configurations) :
+    mConfigurations(configurations),
+    mNext(0)
+{
+}
+
+void ReplayWorkList::add(ExecutableConfigurationConstPtr, AppModelConstPtr, string)
+{
+}
+
+ExecutableConfigurationConstPtr ReplayWorkList::remove()
+{
+    Q_ASSERT(!empty());
+    return mConfigurations.at(mNext++);
+}
+
+void ReplayWorkList::reprioritize(AppModelConstPtr)
+{
+}
+
+int ReplayWorkList::size()
+{
+    return mConfigurations.size() - mNext;
+}
+
+bool ReplayWorkList::empty()
+{
+    return mNext >= mConfigurations.size();
+}
+
+void ReplayWorkList::readFile(const QString&)
+{
+}
+
+QList<WorkListItem> ReplayWorkList::snapshot() const
+{
+    QList<WorkListItem> items;
+
+    for (int i = mNext; i < mConfigurations.size(); i++) {
+        items.append(WorkListItem(0, mConfigurations.at(i)));
+    }
+
+    return items;
+}
+
+QString ReplayWorkList::toString() const
+{
+    QString output;
+
+    foreach (WorkListItem item, snapshot()) {
+        output += item.second->toString() + QString("\n");
+    }
+
+    return output;
+}
+
+}
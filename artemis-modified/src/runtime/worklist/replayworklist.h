@@ -0,0 +1,59 @@
+/*
+ * Copyright 2012 Aarhus University
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef REPLAYWORKLIST_H
+#define REPLAYWORKLIST_H
+
+#include <QList>
+
+#include "worklist.h"
+
+namespace artemis
+{
+
+/**
+ * @brief The ReplayWorkList class
+ *
+ * Hands out the configurations of a recorded run (see RunLog) in the recorded order. Added
+ * configurations are ignored and priorities are never computed.
+ */
+class ReplayWorkList : public WorkList
+{
+
+public:
+    ReplayWorkList(const QList<ExecutableConfigurationConstPtr>& configurations);
+
+    void add(ExecutableConfigurationConstPtr configuration, AppModelConstPtr appmodel, string dependencyString);
+    ExecutableConfigurationConstPtr remove();
+
+    void reprioritize(AppModelConstPtr appmodel);
+
+    int size();
+    bool empty();
+
+    void readFile(const QString& path);
+
+    QList<WorkListItem> snapshot() const;
+
+    QString toString() const;
+
+private:
+    QList<ExecutableConfigurationConstPtr> mConfigurations;
+    int mNext;
+};
+
+}
+
+#endif // REPLAYWORKLIST_H
@@ -16,6 +16,8 @@
 #ifndef WORKLIST_H
 #define WORKLIST_H
 
+#include <QList>
+#include <QPair>
 #include <QString>
 #include <QSharedPointer>
 
@@ -25,6 +27,16 @@
 namespace artemis
 {
 
+typedef QPair<double, ExecutableConfigurationConstPtr> WorkListItem;
+
+// MODIFIED by CH
+// A configuration the worklist keeps on disk instead of in memory
+struct SpilledWorkListItem
+{
+    double stalePriority; // when it was written out, it is rescored once it is read back
+    qint64 offset; // in the spill file
+};
+
 class WorkList
 {
 
@@ -41,7 +53,19 @@ public:
     virtual bool empty() = 0;
 
     // MODIFIED by CH
-    virtual void readFile(QUrl) = 0;
+    virtual void readFile(const QString& path) = 0;
+
+    // MODIFIED by CH
+    // The queued configurations kept in memory with their priorities, in the order they would be
+    // removed. Does not modify the worklist.
+    virtual QList<WorkListItem> snapshot() const = 0;
+
+    // The queued configurations not kept in memory, in the order they would be read back. Their
+    // configurations are not read for this.
+    virtual QList<SpilledWorkListItem> spilledSnapshot() const
+    {
+        return QList<SpilledWorkListItem>();
+    }
 
     virtual QString toString() const = 0;
 };
@@ -0,0 +1,153 @@
+/*
+ * Copyright 2012 Aarhus University
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+
+#include "worklistheap.h"
+
+namespace artemis
+{
+
+WorkListHeap::WorkListHeap()
+{
+}
+
+WorkListHeap::~WorkListHeap()
+{
+    for (size_t i = 0; i < mHeap.size(); i++) {
+        delete mHeap[i];
+    }
+}
+
+void WorkListHeap::push(WorkListEntry* entry)
+{
+    Q_ASSERT(entry->heapIndex == -1);
+
+    mHeap.push_back(entry);
+    entry->heapIndex = mHeap.size() - 1;
+
+    siftUp(entry->heapIndex);
+}
+
+WorkListEntry* WorkListHeap::top() const
+{
+    Q_ASSERT(!mHeap.empty());
+    return mHeap.front();
+}
+
+WorkListEntry* WorkListHeap::pop()
+{
+    Q_ASSERT(!mHeap.empty());
+
+    WorkListEntry* entry = mHeap.front();
+    WorkListEntry* last = mHeap.back();
+    mHeap.pop_back();
+
+    if (!mHeap.empty()) {
+        place(0, last);
+        siftDown(0);
+    }
+
+    entry->heapIndex = -1;
+    return entry;
+}
+
+void WorkListHeap::update(WorkListEntry* entry, double priority)
+{
+    Q_ASSERT(entry->heapIndex >= 0 && entry->heapIndex < (int)mHeap.size());
+
+    double old = entry->priority;
+    entry->priority = priority;
+
+    if (priority > old) {
+        siftUp(entry->heapIndex);
+    } else if (priority < old) {
+        siftDown(entry->heapIndex);
+    }
+}
+
+std::vector<const WorkListEntry*> WorkListHeap::snapshot() const
+{
+    std::vector<const WorkListEntry*> entries(mHeap.begin(), mHeap.end());
+    std::sort(entries.begin(), entries.end(), before);
+
+    return entries;
+}
+
+std::vector<WorkListEntry*> WorkListHeap::takeAll()
+{
+    std::vector<WorkListEntry*> entries;
+    entries.swap(mHeap);
+
+    for (size_t i = 0; i < entries.size(); i++) {
+        entries[i]->heapIndex = -1;
+    }
+
+    return entries;
+}
+
+void WorkListHeap::place(int index, WorkListEntry* entry)
+{
+    mHeap[index] = entry;
+    entry->heapIndex = index;
+}
+
+void WorkListHeap::siftUp(int index)
+{
+    WorkListEntry* entry = mHeap[index];
+
+    while (index > 0) {
+        int parent = (index - 1) / 2;
+
+        if (!before(entry, mHeap[parent])) {
+            break;
+        }
+
+        place(index, mHeap[parent]);
+        index = parent;
+    }
+
+    place(index, entry);
+}
+
+void WorkListHeap::siftDown(int index)
+{
+    WorkListEntry* entry = mHeap[index];
+    int size = mHeap.size();
+
+    while (true) {
+        int child = 2 * index + 1;
+
+        if (child >= size) {
+            break;
+        }
+
+        if (child + 1 < size && before(mHeap[child + 1], mHeap[child])) {
+            child++;
+        }
+
+        if (!before(mHeap[child], entry)) {
+            break;
+        }
+
+        place(index, mHeap[child]);
+        index = child;
+    }
+
+    place(index, entry);
+}
+
+}
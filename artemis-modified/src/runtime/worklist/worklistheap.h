@@ -0,0 +1,167 @@
+/*
+ * Copyright 2012 Aarhus University
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef WORKLISTHEAP_H
+#define WORKLISTHEAP_H
+
+#include <vector>
+
+#include <QtGlobal>
+
+#include "runtime/executableconfiguration.h"
+
+namespace artemis
+{
+
+struct WorkListEntry
+{
+    WorkListEntry(double priority, quint64 order, ExecutableConfigurationConstPtr configuration) :
+        priority(priority),
+        order(order),
+        configuration(configuration),
+        heapIndex(-1)
+    {
+    }
+
+    double priority;
+
+    // insertion number, breaks ties between equal priorities in FIFO order
+    quint64 order;
+
+    ExecutableConfigurationConstPtr configuration;
+
+    // position in the heap, -1 while the entry is not in a heap
+    int heapIndex;
+};
+
+/**
+ * @brief The WorkListHeap class
+ *
+ * Binary max-heap of WorkListEntry pointers. Entries know their own position in the heap, so the
+ * priority of an entry already in the heap can be changed in O(log n) (see update).
+ *
+ * The heap owns the entries it contains; pop hands ownership back to the caller.
+ *
+ * The entries can be traversed read-only, either in heap order (begin/end, no cost besides the
+ * traversal) or in the order they would be popped (snapshot). Neither modifies the heap.
+ */
+class WorkListHeap
+{
+
+public:
+    class const_iterator
+    {
+
+    public:
+        const_iterator(std::vector<WorkListEntry*>::const_iterator iter) :
+            mIter(iter)
+        {
+        }
+
+        inline const WorkListEntry* operator*() const
+        {
+            return *mIter;
+        }
+
+        inline const WorkListEntry* operator->() const
+        {
+            return *mIter;
+        }
+
+        inline const_iterator& operator++()
+        {
+            ++mIter;
+            return *this;
+        }
+
+        inline const_iterator operator++(int)
+        {
+            const_iterator old = *this;
+            ++mIter;
+            return old;
+        }
+
+        inline bool operator==(const const_iterator& other) const
+        {
+            return mIter == other.mIter;
+        }
+
+        inline bool operator!=(const const_iterator& other) const
+        {
+            return mIter != other.mIter;
+        }
+
+    private:
+        std::vector<WorkListEntry*>::const_iterator mIter;
+    };
+
+    WorkListHeap();
+    ~WorkListHeap();
+
+    void push(WorkListEntry* entry);
+    WorkListEntry* top() const;
+    WorkListEntry* pop();
+
+    void update(WorkListEntry* entry, double priority);
+
+    inline int size() const
+    {
+        return mHeap.size();
+    }
+
+    inline bool empty() const
+    {
+        return mHeap.empty();
+    }
+
+    inline const_iterator begin() const
+    {
+        return const_iterator(mHeap.begin());
+    }
+
+    inline const_iterator end() const
+    {
+        return const_iterator(mHeap.end());
+    }
+
+    // all entries, highest priority first
+    std::vector<const WorkListEntry*> snapshot() const;
+
+    // removes all entries, in no particular order, ownership goes to the caller
+    std::vector<WorkListEntry*> takeAll();
+
+    // true if lhs is removed before rhs
+    static inline bool before(const WorkListEntry* lhs, const WorkListEntry* rhs)
+    {
+        if (lhs->priority != rhs->priority) {
+            return lhs->priority > rhs->priority;
+        }
+
+        return lhs->order < rhs->order;
+    }
+
+private:
+    void place(int index, WorkListEntry* entry);
+    void siftUp(int index);
+    void siftDown(int index);
+
+    std::vector<WorkListEntry*> mHeap;
+
+    Q_DISABLE_COPY(WorkListHeap)
+};
+
+}
+
+#endif // WORKLISTHEAP_H
@@ -24,6 +24,7 @@
 #include "runtime/input/dominput.h"
 #include "runtime/input/timerinput.h"
 #include "runtime/input/ajaxinput.h"
+#include "statistics/statsstorage.h"
 
 #include "randominputgenerator.h"
 
@@ -94,24 +95,59 @@ QList<QSharedPointer<ExecutableConfiguration> > RandomInputGenerator::insertSame
         newConfigurations.append(newConf);
 
         /**
-         * // TODO
-         *
          * The above code will generate duplicates of the same sequence over time, as the variants generator can repeat already
-         * used parameters. Is this a good way to extend our test sequences? And if so should we put in some "isEqual"-ish check
-         * to avoid duplications?
+         * used parameters. The worklist drops them when started with --duplicate-filter.
          */
     }
 
     return newConfigurations;
 }
 
+// MODIFIED by CH
+/**
+ * The event handlers of the result, the ones on elements changed by the sequence first (with
+ * --dom-diff), so they are taken from the worklist first among configurations of equal priority
+ */
+QList<EventHandlerDescriptor*> RandomInputGenerator::orderByModifiedRegions(QSharedPointer<const ExecutionResult> result) const
+{
+    QList<DomPath> regions = result->getModifiedRegions();
+
+    if (regions.isEmpty()) {
+        return result->getEventHandlers();
+    }
+
+    QList<EventHandlerDescriptor*> inside;
+    QList<EventHandlerDescriptor*> outside;
+
+    foreach (EventHandlerDescriptor* handler, result->getEventHandlers()) {
+        bool isModified = false;
+
+        foreach (const DomPath& region, regions) {
+            if (handler->domElement()->isInside(region)) {
+                isModified = true;
+                break;
+            }
+        }
+
+        if (isModified) {
+            inside.append(handler);
+        } else {
+            outside.append(handler);
+        }
+    }
+
+    statistics()->accumulate("InputGenerator::handlers-in-modified-regions", inside.size());
+
+    return inside + outside;
+}
+
 QList<QSharedPointer<ExecutableConfiguration> > RandomInputGenerator::insertExtended(
         QSharedPointer<const ExecutableConfiguration> oldConfiguration,
         QSharedPointer<const ExecutionResult> result)
 {
     QList<QSharedPointer<ExecutableConfiguration> > newConfigurations;
 
-    foreach (EventHandlerDescriptor* ee, result->getEventHandlers()) {
+    foreach (EventHandlerDescriptor* ee, orderByModifiedRegions(result)) {
         EventParameters* newParams = mEventParameterGenerator->generateEventParameters(NULL, ee);
         TargetDescriptor* target = mTargetGenerator->generateTarget(NULL, ee);
         QSharedPointer<FormInput> newForm = mFormInputGenerator->generateFormFields(NULL, result->getFormFields(), result);
@@ -52,6 +52,9 @@ private:
     QList<QSharedPointer<ExecutableConfiguration> > insertSameLength(QSharedPointer<const ExecutableConfiguration> e, QSharedPointer<const ExecutionResult> result);
     QList<QSharedPointer<ExecutableConfiguration> > insertExtended(QSharedPointer<const ExecutableConfiguration> e, QSharedPointer<const ExecutionResult> result);
 
+    // MODIFIED by CH
+    QList<EventHandlerDescriptor*> orderByModifiedRegions(QSharedPointer<const ExecutionResult> result) const;
+
     TargetGenerator* mTargetGenerator;
 
     int mNumberSameLength;
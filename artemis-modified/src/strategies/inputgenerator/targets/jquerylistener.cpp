@@ -75,6 +75,31 @@ QList<QString> JQueryListener::lookup(QString elementSignature, QString event)
     return result;
 }
 
+// MODIFIED by CH
+void JQueryListener::write(QDataStream& stream) const
+{
+    stream << (quint32)jqueryEvents.size();
+
+    foreach (jqueryEvent* e, jqueryEvents) {
+        stream << e->elementSignature << e->event << e->selector;
+    }
+}
+
+void JQueryListener::read(QDataStream& stream)
+{
+    reset();
+
+    quint32 size;
+    stream >> size;
+
+    for (quint32 i = 0; i < size && stream.status() == QDataStream::Ok; i++) {
+        jqueryEvent* e = new jqueryEvent();
+        stream >> e->elementSignature >> e->event >> e->selector;
+
+        jqueryEvents.append(e);
+    }
+}
+
 void JQueryListener::slEventAdded(QString elementSignature, QString event, QString selector)
 {
     jqueryEvent* e = new jqueryEvent();
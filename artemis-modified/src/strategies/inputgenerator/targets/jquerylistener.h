@@ -16,6 +16,7 @@
 
 #include <QObject>
 #include <QList>
+#include <QDataStream>
 
 #ifndef JQUERYLISTENER_H
 #define JQUERYLISTENER_H
@@ -38,6 +39,11 @@ public:
     void reset();
     QList<QString> lookup(QString elementSignature, QString event);
 
+    // MODIFIED by CH
+    // Copies the registered events to/from another process, read replaces all events
+    void write(QDataStream& stream) const;
+    void read(QDataStream& stream);
+
 protected:
     QList<jqueryEvent*> jqueryEvents;
 
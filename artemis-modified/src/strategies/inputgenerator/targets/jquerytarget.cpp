@@ -76,7 +76,7 @@ QWebElement JQueryTarget::get(ArtemisWebPagePtr page) const
     }
 
     /* Select random selector */
-    QString selector = pickRand(selectors);
+    QString selector = pickTargetRand(selectors);
 
     /* Select target element */
     //QWebElementCollection elements = page->currentFrame()->findAllElements(selector);
@@ -88,7 +88,7 @@ QWebElement JQueryTarget::get(ArtemisWebPagePtr page) const
 
     }
     else {
-        QWebElement element = pickRand(elements.toList());
+        QWebElement element = pickTargetRand(elements.toList());
 
         QString name = element.tagName();
         qDebug() << "TARGET::Selecting element " << name << " out of a total of " << elements.count() << "element(s) and " << selectors.count() << " selector(s)" << endl;
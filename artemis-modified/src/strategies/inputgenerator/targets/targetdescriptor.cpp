@@ -24,4 +24,10 @@ TargetDescriptor::TargetDescriptor(QObject* parent, const EventHandlerDescriptor
     mEventHandler = new EventHandlerDescriptor(this, eventHandler);
 }
 
+// MODIFIED by CH
+fingerprint_t TargetDescriptor::fingerprint() const
+{
+    return fingerprintCombine(fingerprintString(metaObject()->className()), mEventHandler->fingerprint());
+}
+
 }
@@ -22,6 +22,7 @@
 #include "runtime/input/events/eventhandlerdescriptor.h"
 
 #include "runtime/browser/artemiswebpage.h"
+#include "util/fingerprintutil.h"
 
 namespace artemis
 {
@@ -35,6 +36,10 @@ public:
 
     virtual QWebElement get(ArtemisWebPagePtr page) const = 0;
 
+    // MODIFIED by CH
+    // Identifies how the element is chosen, the choice itself is seeded per input (see seedTargetRandom)
+    virtual fingerprint_t fingerprint() const;
+
 protected:
     EventHandlerDescriptor* mEventHandler;
 };
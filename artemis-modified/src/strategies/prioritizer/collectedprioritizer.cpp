@@ -34,6 +34,18 @@ double CollectedPrioritizer::prioritize(QSharedPointer<const ExecutableConfigura
     return priority;
 }
 
+// MODIFIED by CH
+bool CollectedPrioritizer::isIncremental() const
+{
+    list<PrioritizerStrategy*>::const_iterator iter;
+    for(iter = strategies->begin(); iter != strategies->end(); iter++){
+        if (!(*iter)->isIncremental()) {
+            return false;
+        }
+    }
+    return true;
+}
+
 void CollectedPrioritizer::addPrioritizer(PrioritizerStrategy* strategy){
     strategies->push_front(strategy);
 }
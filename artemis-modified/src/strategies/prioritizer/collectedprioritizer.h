@@ -13,6 +13,8 @@ public:
     double prioritize(QSharedPointer<const ExecutableConfiguration> newConf,
                       AppModelConstPtr);
     void addPrioritizer(PrioritizerStrategy* strategy);
+    // MODIFIED by CH
+    bool isIncremental() const;
 private:
     list<PrioritizerStrategy*>* strategies;
 };
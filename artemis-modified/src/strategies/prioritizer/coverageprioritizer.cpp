@@ -29,9 +29,10 @@ double CoveragePrioritizer::prioritize(ExecutableConfigurationConstPtr configura
                                        AppModelConstPtr appmodel)
 {
     float coverage = 1;
+    InputSequenceConstPtr sequence = configuration->getInputSequence();
 
-    foreach(QSharedPointer<const BaseInput> input, configuration->getInputSequence()->toList()) {
-        coverage = coverage * appmodel->getCoverageListener()->getBytecodeCoverage(input);
+    for (InputSequence::const_reverse_iterator input = sequence->rbegin(); input != sequence->rend(); ++input) {
+        coverage = coverage * appmodel->getCoverageListener()->getBytecodeCoverage(*input);
     }
 
     assert(coverage >= 0 && coverage <= 1);
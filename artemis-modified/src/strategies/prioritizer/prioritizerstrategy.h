@@ -33,6 +33,14 @@ public:
 
     virtual double prioritize(QSharedPointer<const ExecutableConfiguration> newConf,
                               AppModelConstPtr appmodel) = 0;
+
+    // MODIFIED by CH
+    // True if the priority of a configuration only changes when the statistics collected for one
+    // of its own inputs change. The worklist then only rescores configurations with changed inputs.
+    virtual bool isIncremental() const
+    {
+        return true;
+    }
 };
 
 typedef QSharedPointer<PrioritizerStrategy> PrioritizerStrategyPtr;
@@ -29,6 +29,12 @@ public:
     double prioritize(QSharedPointer<const ExecutableConfiguration> newConf,
                       AppModelConstPtr);
 
+    // MODIFIED by CH
+    bool isIncremental() const
+    {
+        return false;
+    }
+
 };
 
 }
@@ -35,15 +35,15 @@ double ReadWritePrioritizer::prioritize(QSharedPointer<const ExecutableConfigura
         return 0;
     }
 
-    QList<QSharedPointer<const BaseInput> > inputSequence = configuration->getInputSequence()->toList();
-    QSharedPointer<const BaseInput> last = inputSequence.last();
-    inputSequence.removeLast();
+    InputSequenceConstPtr inputSequence = configuration->getInputSequence();
+    InputSequence::const_reverse_iterator input = inputSequence->rbegin();
+    QSharedPointer<const BaseInput> last = *input++;
 
     QSet<QString> propertiesReadByLast = appmodel->getJavascriptStatistics()->getPropertiesRead(last);
     QSet<QString> properitesWrittenBeforeLast;
 
-    foreach(QSharedPointer<const BaseInput> input, inputSequence) {
-        properitesWrittenBeforeLast.unite(appmodel->getJavascriptStatistics()->getPropertiesWritten(input));
+    for (; input != inputSequence->rend(); ++input) {
+        properitesWrittenBeforeLast.unite(appmodel->getJavascriptStatistics()->getPropertiesWritten(*input));
     }
 
     return float(properitesWrittenBeforeLast.intersect(propertiesReadByLast).size() + 1) / float(propertiesReadByLast.size() + 1);
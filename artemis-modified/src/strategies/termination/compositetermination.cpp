@@ -0,0 +1,64 @@
+/*
+ * Copyright 2012 Aarhus University
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <QStringList>
+
+#include "compositetermination.h"
+
+namespace artemis
+{
+
+CompositeTermination::CompositeTermination(QObject* parent, CompositeTerminationModes mode) :
+    TerminationStrategy(parent),
+    mMode(mode)
+{
+}
+
+void CompositeTermination::addStrategy(TerminationStrategy* strategy)
+{
+    strategy->setParent(this);
+    mStrategies.append(strategy);
+}
+
+bool CompositeTermination::shouldTerminate()
+{
+    mTerminated.clear();
+
+    foreach (TerminationStrategy* strategy, mStrategies) {
+        if (strategy->shouldTerminate()) {
+            mTerminated.append(strategy);
+        }
+    }
+
+    if (mMode == TERMINATE_ALL) {
+        return !mStrategies.isEmpty() && mTerminated.size() == mStrategies.size();
+    }
+
+    return !mTerminated.isEmpty();
+}
+
+QString CompositeTermination::reason()
+{
+    QStringList reasons;
+
+    foreach (TerminationStrategy* strategy, mTerminated) {
+        reasons.append(strategy->reason());
+    }
+
+    return reasons.join(", ");
+}
+
+}
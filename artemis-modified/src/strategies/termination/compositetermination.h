@@ -0,0 +1,58 @@
+/*
+ * Copyright 2012 Aarhus University
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef COMPOSITETERMINATION_H
+#define COMPOSITETERMINATION_H
+
+#include <QList>
+
+#include "terminationstrategy.h"
+
+namespace artemis
+{
+
+enum CompositeTerminationModes {
+    TERMINATE_ANY, TERMINATE_ALL
+};
+
+/**
+ * @brief The CompositeTermination class
+ *
+ * Terminates when any, or all, of its strategies would terminate. Every strategy is asked on every
+ * call, as strategies may count the calls.
+ */
+class CompositeTermination : public TerminationStrategy
+{
+
+public:
+    CompositeTermination(QObject* parent, CompositeTerminationModes mode);
+
+    // takes ownership of strategy
+    void addStrategy(TerminationStrategy* strategy);
+
+    bool shouldTerminate();
+    QString reason();
+
+private:
+    CompositeTerminationModes mMode;
+    QList<TerminationStrategy*> mStrategies;
+
+    // the strategies which would terminate on the last call
+    QList<TerminationStrategy*> mTerminated;
+};
+
+}
+
+#endif // COMPOSITETERMINATION_H
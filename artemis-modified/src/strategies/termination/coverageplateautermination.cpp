@@ -0,0 +1,60 @@
+/*
+ * Copyright 2012 Aarhus University
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "coverageplateautermination.h"
+
+namespace artemis
+{
+
+CoveragePlateauTermination::CoveragePlateauTermination(QObject* parent, AppModelPtr appmodel, int iterations, int seconds) :
+    TerminationStrategy(parent),
+    mAppmodel(appmodel),
+    mIterationLimit(iterations),
+    mTimeLimit((qint64)seconds * 1000),
+    mCoveredLines(0),
+    mIterationsWithoutProgress(-1) // the first call is before the first execution
+{
+    mTimeWithoutProgress.start();
+}
+
+/**
+ * Called once per iteration, before the next configuration is executed.
+ */
+bool CoveragePlateauTermination::shouldTerminate()
+{
+    size_t coveredLines = mAppmodel->getCoverageListener()->getNumCoveredLines();
+
+    if (coveredLines > mCoveredLines) {
+        mCoveredLines = coveredLines;
+        mIterationsWithoutProgress = 0;
+        mTimeWithoutProgress.restart();
+        return false;
+    }
+
+    mIterationsWithoutProgress++;
+
+    return (mIterationLimit > 0 && mIterationsWithoutProgress >= mIterationLimit) ||
+           (mTimeLimit > 0 && mTimeWithoutProgress.hasExpired(mTimeLimit));
+}
+
+QString CoveragePlateauTermination::reason()
+{
+    return QString("No new lines covered for %1 iterations (%2 seconds)")
+            .arg(mIterationsWithoutProgress)
+            .arg(mTimeWithoutProgress.elapsed() / 1000);
+}
+
+}
@@ -0,0 +1,54 @@
+/*
+ * Copyright 2012 Aarhus University
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef COVERAGEPLATEAUTERMINATION_H
+#define COVERAGEPLATEAUTERMINATION_H
+
+#include <QElapsedTimer>
+
+#include "runtime/appmodel.h"
+
+#include "terminationstrategy.h"
+
+namespace artemis
+{
+
+/**
+ * @brief The CoveragePlateauTermination class
+ *
+ * Terminates when no new line was covered for the given number of iterations, or for the given
+ * number of seconds. Either limit is not used if it is 0.
+ */
+class CoveragePlateauTermination : public TerminationStrategy
+{
+
+public:
+    CoveragePlateauTermination(QObject* parent, AppModelPtr appmodel, int iterations, int seconds);
+    bool shouldTerminate();
+    QString reason();
+
+private:
+    AppModelPtr mAppmodel;
+    int mIterationLimit;
+    qint64 mTimeLimit;
+
+    size_t mCoveredLines;
+    int mIterationsWithoutProgress;
+    QElapsedTimer mTimeWithoutProgress;
+};
+
+}
+
+#endif // COVERAGEPLATEAUTERMINATION_H
@@ -0,0 +1,38 @@
+/*
+ * Copyright 2012 Aarhus University
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "timebudgettermination.h"
+
+namespace artemis
+{
+
+TimeBudgetTermination::TimeBudgetTermination(QObject* parent, int seconds) : TerminationStrategy(parent)
+{
+    mBudget = (qint64)seconds * 1000;
+    mTimer.start();
+}
+
+bool TimeBudgetTermination::shouldTerminate()
+{
+    return mTimer.hasExpired(mBudget);
+}
+
+QString TimeBudgetTermination::reason()
+{
+    return QString("Exceeded the time budget of %1 seconds").arg(mBudget / 1000);
+}
+
+}
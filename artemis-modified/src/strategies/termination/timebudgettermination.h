@@ -0,0 +1,47 @@
+/*
+ * Copyright 2012 Aarhus University
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef TIMEBUDGETTERMINATION_H
+#define TIMEBUDGETTERMINATION_H
+
+#include <QElapsedTimer>
+
+#include "terminationstrategy.h"
+
+namespace artemis
+{
+
+/**
+ * @brief The TimeBudgetTermination class
+ *
+ * Terminates once the given number of seconds has passed since the strategy was created, measured
+ * with a monotonic clock.
+ */
+class TimeBudgetTermination : public TerminationStrategy
+{
+
+public:
+    TimeBudgetTermination(QObject* parent, int seconds);
+    bool shouldTerminate();
+    QString reason();
+
+private:
+    qint64 mBudget;
+    QElapsedTimer mTimer;
+};
+
+}
+
+#endif // TIMEBUDGETTERMINATION_H
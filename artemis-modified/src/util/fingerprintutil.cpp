@@ -0,0 +1,59 @@
+/*
+ * Copyright 2012 Aarhus University
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "fingerprintutil.h"
+
+namespace artemis
+{
+
+fingerprint_t fingerprintString(const QString& str, fingerprint_t seed)
+{
+    fingerprint_t hash = seed;
+    const ushort* data = str.utf16();
+
+    for (int i = 0; i < str.size(); i++) {
+        hash ^= data[i];
+        hash *= Q_UINT64_C(0x100000001b3);
+    }
+
+    return hash;
+}
+
+fingerprint_t fingerprintBytes(const QByteArray& bytes, fingerprint_t seed)
+{
+    fingerprint_t hash = seed;
+    const uchar* data = (const uchar*)bytes.constData();
+
+    for (int i = 0; i < bytes.size(); i++) {
+        hash ^= data[i];
+        hash *= Q_UINT64_C(0x100000001b3);
+    }
+
+    return hash;
+}
+
+fingerprint_t fingerprintCombine(fingerprint_t seed, fingerprint_t value)
+{
+    // splitmix64 finalizer
+    fingerprint_t hash = seed ^ (value + Q_UINT64_C(0x9e3779b97f4a7c15) + (seed << 6) + (seed >> 2));
+
+    hash = (hash ^ (hash >> 30)) * Q_UINT64_C(0xbf58476d1ce4e5b9);
+    hash = (hash ^ (hash >> 27)) * Q_UINT64_C(0x94d049bb133111eb);
+
+    return hash ^ (hash >> 31);
+}
+
+}
@@ -0,0 +1,40 @@
+/*
+ * Copyright 2012 Aarhus University
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef FINGERPRINTUTIL_H
+#define FINGERPRINTUTIL_H
+
+#include <QtGlobal>
+#include <QByteArray>
+#include <QString>
+
+namespace artemis
+{
+
+typedef quint64 fingerprint_t;
+
+const fingerprint_t FINGERPRINT_SEED = Q_UINT64_C(0xcbf29ce484222325);
+
+// 64 bit FNV-1a over the UTF-16 code units of str
+fingerprint_t fingerprintString(const QString& str, fingerprint_t seed = FINGERPRINT_SEED);
+
+// 64 bit FNV-1a over bytes
+fingerprint_t fingerprintBytes(const QByteArray& bytes, fingerprint_t seed = FINGERPRINT_SEED);
+
+// order dependent combination of two fingerprints
+fingerprint_t fingerprintCombine(fingerprint_t seed, fingerprint_t value);
+
+}
+#endif // FINGERPRINTUTIL_H
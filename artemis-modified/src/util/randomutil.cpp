@@ -13,6 +13,8 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include <stdlib.h>
+
 #include "randomutil.h"
 #include <QSet>
 
@@ -72,4 +74,32 @@ QString generateRandomJsId()
     return generateRandomString(5);
 }
 
+// MODIFIED by CH
+static uint targetRandomState = 0;
+
+void seedTargetRandom(uint seed)
+{
+    targetRandomState = seed;
+}
+
+QWebElement pickTargetRand(QList<QWebElement> s)
+{
+    if (s.size() == 1) {
+        return s.at(0);
+    }
+
+    int elem = rand_r(&targetRandomState) % (s.size() - 1);
+    return s.at(elem);
+}
+
+QString pickTargetRand(QList<QString> s)
+{
+    if (s.size() == 1) {
+        return s.at(0);
+    }
+
+    int elem = rand_r(&targetRandomState) % (s.size() - 1);
+    return s.at(elem);
+}
+
 }
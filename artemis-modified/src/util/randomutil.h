@@ -31,5 +31,11 @@ QString pickRand(QSet<QString> s);
 
 QString generateRandomJsId();
 
+// MODIFIED by CH
+// Target choices use their own generator, seeded per input, so a replayed input picks the same element
+void seedTargetRandom(uint seed);
+QWebElement pickTargetRand(QList<QWebElement> s);
+QString pickTargetRand(QList<QString> s);
+
 }
 #endif // RANDOMUTIL_H
@@ -26,4 +26,5 @@ do
     rm ../benchmarks/$name/info/numConstraints.txt
     rm ../benchmarks/$name/info/z3.time
     rm ../benchmarks/$name/info/dep.txt
+    rm -f ../benchmarks/$name/info/dep.bin
 done
@@ -20,6 +20,7 @@ build_deps() {
     DIRNAME=$1
     $TIME ./makeDeps.sh ${DIRNAME}/index.js 2>${DIRNAME}/info/z3.time
     mv ./result_query.txt ${DIRNAME}/info/dep.txt
+    node ../src/compiledeps.js ${DIRNAME}/info/dep.txt ${DIRNAME}/info/dep.bin
     mv ./numConstraints.txt ${DIRNAME}/info/numConstraints.txt
 }
 
@@ -43,7 +44,6 @@ run_artemis() {
         exit
     fi
 
-    # move in the deps file so artemis can find it
     DIRNAME=$1
     depFile=${DIRNAME}/info/dep.txt
     if [ ! -f $depFile ]
@@ -51,6 +51,12 @@ run_artemis() {
         echo "depFile not found: $depFile"
         exit
     fi
+    # prefer the compiled deps file, artemis maps it instead of parsing dep.txt
+    if [ -f ${DIRNAME}/info/dep.bin ]
+    then
+        depFile=${DIRNAME}/info/dep.bin
+    fi
+    depFile=`realpath $depFile`
     HTMLFILE=${DIRNAME}/index.html
     #make the path absolute and append the file:/// thing for webkit
     mkdir -p ${DIRNAME}/artemis-result
@@ -61,8 +67,7 @@ run_artemis() {
     OUT=${DIRNAME}/artemis-result/old_artemis.stdout
     $ARTEMIS $BIG_PATH -i $2 -q 0 --strategy-priority all 1>"${OUT}"
 
-    cp $depFile dep.txt
-    echo "running new version: $ARTEMIS $BIG_PATH -i $2 -q 1"
+    echo "running new version: $ARTEMIS $BIG_PATH -i $2 -q 1 --dependency-file $depFile"
     OUT=${DIRNAME}/artemis-result/new_artemis.stdout
-    $ARTEMIS $BIG_PATH -i $2 -q 1 1>"${OUT}"
+    $ARTEMIS $BIG_PATH -i $2 -q 1 --dependency-file $depFile 1>"${OUT}"
 }
@@ -0,0 +1,97 @@
+var fs = require('fs');
+
+// Compiles a dep.txt into the binary format mmap'ed by the modified Artemis
+// (see artemis-modified/src/runtime/worklist/dependencyindex.cpp).
+//
+// dep.txt lists dependencies as groups of four lines: dom1, event1, dom2, event2.
+// The binary file is little-endian and consists of
+//   header          "ADEP", version, numEvents, numEdges, stringBytes, 3 reserved words
+//   stringOffsets   numEvents + 1 words, offsets of the event keys in the string table
+//   rowOffsets      numEvents + 1 words, offsets of the successors of each event in targets
+//   targets         numEdges words, sorted per event
+//   strings         stringBytes bytes, the UTF-8 event keys ("event@dom" or "timerinput")
+var MAGIC = "ADEP";
+var VERSION = 1;
+var HEADER_WORDS = 8;
+
+function eventKey(dom, event)
+{
+    "use strict";
+    if (event === "timerinput") {
+        return event;
+    }
+    return event + "@" + dom;
+}
+
+function compile(input, output)
+{
+    "use strict";
+    var lines = fs.readFileSync(input).toString().split("\n");
+    var ids = {};
+    var keys = [];
+    var successors = [];
+
+    function intern(key) {
+        if (!ids.hasOwnProperty(key)) {
+            ids[key] = keys.length;
+            keys.push(key);
+            successors.push({});
+        }
+        return ids[key];
+    }
+
+    for (var i = 0; i + 3 < lines.length; i += 4) {
+        var parent = intern(eventKey(lines[i], lines[i + 1]));
+        var child = intern(eventKey(lines[i + 2], lines[i + 3]));
+        successors[parent][child] = true;
+    }
+
+    var strings = [];
+    var stringOffsets = [0];
+    var rowOffsets = [0];
+    var targets = [];
+
+    for (var id = 0; id < keys.length; id++) {
+        var bytes = Buffer.from(keys[id], "utf8");
+        strings.push(bytes);
+        stringOffsets.push(stringOffsets[id] + bytes.length);
+
+        var row = Object.keys(successors[id]).map(Number).sort(function (a, b) { return a - b; });
+        targets = targets.concat(row);
+        rowOffsets.push(targets.length);
+    }
+
+    var stringBytes = stringOffsets[keys.length];
+    var words = HEADER_WORDS + stringOffsets.length + rowOffsets.length + targets.length;
+    var buffer = Buffer.alloc(words * 4 + stringBytes);
+    var offset = 0;
+
+    function word(value) {
+        buffer.writeUInt32LE(value, offset);
+        offset += 4;
+    }
+
+    buffer.write(MAGIC, 0, "ascii");
+    offset = 4;
+    word(VERSION);
+    word(keys.length);
+    word(targets.length);
+    word(stringBytes);
+    word(0);
+    word(0);
+    word(0);
+    stringOffsets.forEach(word);
+    rowOffsets.forEach(word);
+    targets.forEach(word);
+    Buffer.concat(strings).copy(buffer, offset);
+
+    fs.writeFileSync(output, buffer);
+    console.log(input + ": " + keys.length + " events, " + targets.length + " dependencies");
+}
+
+if (process.argv.length !== 4) {
+    console.log("usage: node compiledeps.js <dep.txt> <dep.bin>");
+    process.exit(1);
+}
+
+compile(process.argv[2], process.argv[3]);